@@ -1,12 +1,16 @@
 #include <math.h>
-#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "TalkBox32.h"
 #include "calcAutoCoeff32.h"
 #include "durbin32.h"
+#include "schur32.h"
 #include "lpcFilter32.h"
+#include "latticeFilter32.h"
 #include "log32.h"
+#include "lpcFrameStream32.h"
+#include "cycleCounter.h"
 
 #define M_PI    3.14159265358979323846
 
@@ -33,105 +37,399 @@ inline int32_t highpass32(int32_t in, int32_t coeff, int32_t *mem)
     return (in - out);
 }
 
-TalkBox32::TalkBox32(double fs)
+/* statistics with a single writer, relaxed loads and stores instead of locked instructions */
+
+inline void statAdd(std::atomic<uint64_t> &stat, uint64_t value)
+{
+    stat.store(stat.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+inline void statMin(std::atomic<uint64_t> &stat, uint64_t value)
+{
+    if (value < stat.load(std::memory_order_relaxed))
+        stat.store(value, std::memory_order_relaxed);
+}
+
+inline void statMax(std::atomic<uint64_t> &stat, uint64_t value)
+{
+    if (value > stat.load(std::memory_order_relaxed))
+        stat.store(value, std::memory_order_relaxed);
+}
+
+template <int Order, int BlockLen, int NumAcf>
+TalkBox<Order, BlockLen, NumAcf>::TalkBox(double fs, int num_blocks) : Pipeline(fs, num_blocks)
 {
-    this->fs = fs;
+    // the audio, handoff and analysis members start at cache lines,
+    // the three frames of lpc_frames do not share one
+    static_assert(alignof(TalkBox) == cache_line_size, "TalkBox is not aligned to cache lines");
+    static_assert(sizeof(LPCFrame32<Order>) % cache_line_size == 0, "LPCFrame32 is not padded to cache lines");
+
+    // statistics
+    stats_epoch = 0;
+    clearAudioStats();
+    clearAnalysisStats();
+
+    // non-overlapping blocks
+    hop_size = block_length;
 
     // parameter for smoothing
     setSmoothingTime(0.03f);
 
     // gate off
-    gate_level = 0;
+    gate.level = 0;
 
-    // integer base 2 logarithm of block_length
-    n_shift_block = 0;
-    for (int i=1; i<block_length; i*=2)
-        n_shift_block++;
+    // analysis window for overlapping blocks, periodic hann in 1.31 format
+    for (int i=0; i<block_length; i++)
+        window32[i] = (int32_t) ((0.5 - 0.5 * cos(2 * M_PI * i / block_length)) * 0x7FFFFFFF);
 
     // integer base 2 logarithm of memory_rms_size
     n_shift_memory = 0;
     for (int i=1; i<memory_rms_size; i*=2)
         n_shift_memory++;
 
+    // integer base 2 logarithm of num_acf
+    n_shift_acf = 0;
+    for (int i=1; i<num_acf; i*=2)
+        n_shift_acf++;
+
     // high pass design
-    double ftan = tan(M_PI * 20000. / fs);
-    high_pass_coeff = (int32_t) ((ftan-1) / (ftan+1) * 0x7FFFFFFF);
+    setPreemphasis(20000.f);
+
+    // direct form synthesis filter, frames switched without interpolation
+    use_lattice = false;
+    use_narrow_lattice = false;
+    use_interpolation = false;
+    use_sliding_acf = false;
+    use_schur = false;
+    use_q15 = false;
 
     // set states to null
-    resetStates();
+    for (int i=0; i<num_coeffs; i++)
+        a32[i] = k32[i] = 0;
 
-    sample_buffer = input_buffer0;
-    block_buffer  = input_buffer1;
+    for (int j=0; j<num_acf; j++)
+        for (int i=0; i<num_coeffs + 1; i++)
+            acf32[j][i] = 0;
 
     acf_index = 0;
+
+    // no recording, frames from the analysis
+    recorder = 0;
+    record_failed = false;
+    player = 0;
+
+    // allocates the input ring and resets the states
+    setHopSize(block_length);
 }
 
-TalkBox32::~TalkBox32(void)
+template <int Order, int BlockLen, int NumAcf>
+TalkBox<Order, BlockLen, NumAcf>::~TalkBox(void)
 {
+    stopAnalysisThread();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::startRamp(const LPCFrame32<Order> *frame)
+{
+    int32_t gain;
+
+    ramp_frame = frame;
+
+    // a ramp in progress only advanced k64_ramp
+    if (ramp_count > 0)
+        for (int i = 0; i < num_coeffs; i++)
+            k32_ramp[i] = (int32_t) (k64_ramp[i] >> ramp_fraction);
+
+    // gain * voice_rms of the new frame
+    gain = ((int64_t) frame->error_gain * frame->voice_rms) >> 31;
+
+    // reach the new frame when the next one is due; the hop is a power of
+    // two, so the steps with ramp_fraction more bits are exact and the
+    // accumulated ramps do not drift
+    ramp_count = hop_size;
+    gain64_ramp = (int64_t) gain_ramp << ramp_fraction;
+    gain64_step = (((int64_t) gain - gain_ramp) << ramp_fraction) >> n_shift_hop;
+
+    for (int i = 0; i < num_coeffs; i++)
+    {
+        k64_ramp[i] = (int64_t) k32_ramp[i] << ramp_fraction;
+        k64_step[i] = (((int64_t) frame->k32[i] - k32_ramp[i]) << ramp_fraction) >> n_shift_hop;
+    }
 }
 
-void TalkBox32::process(int32_t samples[])
+template <int Order, int BlockLen, int NumAcf>
+inline int32_t TalkBox<Order, BlockLen, NumAcf>::synthesize(int32_t carrierSample, const LPCFrame32<Order> *frame)
 {
     int32_t temp32;
 
-    // synthesizer signal
-    temp32 = samples[0];
+    if (use_interpolation)
+    {
+        if (frame != ramp_frame)
+            startRamp(frame);
+
+        // linear ramp of the reflection coefficients and the gain, every
+        // set on the way satisfies |k| < k_max; the lattice advances the
+        // coefficients stage by stage
+        if (ramp_count > 1)
+        {
+            ramp_count--;
+
+            gain64_ramp += gain64_step;
+            gain_ramp = (int32_t) (gain64_ramp >> ramp_fraction);
+
+            temp32 = ((int64_t) gain_ramp * carrierSample) >> 31;
+
+            if (use_narrow_lattice)
+                return latticeFilterRamp32<num_coeffs>(temp32, k64_ramp, k64_step, memory_lattice32,
+                                                       fractional_digits, ramp_fraction);
+
+            return latticeFilterRamp32<num_coeffs>(temp32, k64_ramp, k64_step, memory_lattice,
+                                                   fractional_digits, ramp_fraction);
+        }
+
+        // last step of the ramp
+        if (ramp_count == 1)
+        {
+            ramp_count = 0;
+
+            for (int i = 0; i < num_coeffs; i++)
+                k32_ramp[i] = frame->k32[i];
+            gain_ramp = ((int64_t) frame->error_gain * frame->voice_rms) >> 31;
+        }
+
+        temp32 = ((int64_t) gain_ramp * carrierSample) >> 31;
+
+        if (use_narrow_lattice)
+            return latticeFilter32<num_coeffs>(temp32, k32_ramp, memory_lattice32, fractional_digits);
+
+        return latticeFilter32<num_coeffs>(temp32, k32_ramp, memory_lattice, fractional_digits);
+    }
 
     // input * gain
-    temp32 = ((int64_t) error_gain * temp32) >> 31;
+    temp32 = ((int64_t) frame->error_gain * carrierSample) >> 31;
 
     // input * voice_rms
-    temp32 = ((int64_t) voice_rms * temp32) >> 31;
+    temp32 = ((int64_t) frame->voice_rms * temp32) >> 31;
 
     // all-pole filter
-    std::unique_lock<std::mutex> locker(a_coeff_mutex, std::defer_lock);
-    locker.lock();
+    if (use_lattice && use_narrow_lattice)
+        return latticeFilter32<num_coeffs>(temp32, frame->k32, memory_lattice32, fractional_digits);
+
+    if (use_lattice)
+        return latticeFilter32<num_coeffs>(temp32, frame->k32, memory_lattice, fractional_digits);
 
-    samples[0] = lpcFilter32(temp32, a32, memory_lpc, num_coeffs, fractional_digits);
+    return lpcFilterCircular32<num_coeffs>(temp32, frame->a32, memory_lpc, &lpc_position, fractional_digits);
+}
 
-    locker.unlock();
+template <int Order, int BlockLen, int NumAcf>
+inline bool TalkBox<Order, BlockLen, NumAcf>::silentBlock(const LPCFrame32<Order> *frame)
+{
+    // the filter has decayed and the frame has no gain: zero output
+    // without filtering until the next voiced frame
+    if (filter_silent == false)
+        return false;
+
+    if (frame->error_gain != 0 && frame->voice_rms != 0)
+    {
+        filter_silent = false;
+        return false;
+    }
+
+    // with zero memory and input the ramp to this frame is silent, too
+    if (use_interpolation && frame != ramp_frame)
+    {
+        ramp_frame = frame;
+        ramp_count = 0;
+        gain_ramp = 0;
+        for (int i = 0; i < num_coeffs; i++)
+            k32_ramp[i] = frame->k32[i];
+    }
+
+    return true;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::updateSilence(const LPCFrame32<Order> *frame)
+{
+    // after a block without input the all-pole filter decays towards a
+    // limit cycle of a few LSBs, which is cleared below silence_threshold
+    if (frame->error_gain != 0 && frame->voice_rms != 0)
+        return;
+
+    if (use_interpolation && (ramp_count > 0 || gain_ramp != 0))
+        return;
+
+    if ((use_interpolation || use_lattice) && use_narrow_lattice)
+    {
+        if (maxAbs32(memory_lattice32, num_coeffs) > (silence_threshold >> lattice_headroom))
+            return;
+    }
+    else if (use_interpolation || use_lattice)
+    {
+        for (int i = 0; i < num_coeffs; i++)
+            if (llabs(memory_lattice[i]) > ((int64_t) silence_threshold << lattice_fraction))
+                return;
+    }
+    else
+    {
+        if (maxAbs32(memory_lpc, 2 * num_coeffs) > silence_threshold)
+            return;
+    }
+
+    for (int i = 0; i < 2 * num_coeffs; i++)
+        memory_lpc[i] = 0;
+    lpc_position = 0;
+
+    for (int i = 0; i < num_coeffs; i++)
+        memory_lattice[i] = memory_lattice32[i] = 0;
+
+    filter_silent = true;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+bool TalkBox<Order, BlockLen, NumAcf>::synthesizeBlock(const int32_t *carrier, int32_t *out, int stride, int num_samples,
+                                                       int position, const LPCFrame32<Order> *frame)
+{
+    bool silent = true;
+    int n;
+
+    // runs that end at the hop boundaries, position is buffer_position
+    // before the block, the silence is checked there as in process()
+    for (int i = 0; i < num_samples; i += n)
+    {
+        n = hop_size - position;
+        if (n > num_samples - i)
+            n = num_samples - i;
+
+        if (silentBlock(frame))
+        {
+            for (int j = i; j < i + n; j++)
+                out[j * stride] = 0;
+        }
+        else
+        {
+            for (int j = i; j < i + n; j++)
+                out[j * stride] = synthesize(carrier[j * stride], frame);
+
+            silent = false;
+        }
+
+        position += n;
+
+        if (position >= hop_size)
+        {
+            updateSilence(frame);
+            position = 0;
+        }
+    }
+
+    return silent;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::process(int32_t samples[])
+{
+    // latest coefficient set, never blocks
+    const LPCFrame32<Order> *frame = lpc_frames.readBuffer();
+
+    // synthesizer signal * gain * voice_rms, all-pole filter
+    if (silentBlock(frame))
+        samples[0] = 0;
+    else
+        samples[0] = synthesize(samples[0], frame);
 
     // voice signal
     sample_buffer[buffer_position++] = samples[1];
 
-    if (buffer_position >= block_length)
+    if (buffer_position >= hop_size)
     {
-        buffer_position = 0;
+        updateSilence(frame);
+        pushBlock();
+    }
+}
 
-        if (block_ready == true)
-            printf("timing error\n");
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::processBlock(int32_t samples[], int num_samples)
+{
+    uint64_t start = readCycles();
+    int position = buffer_position;
 
-        // swap buffer
-        int32_t *tmp_ptr = block_buffer;
-        block_buffer = sample_buffer;
-        sample_buffer = tmp_ptr;
+    // voice signal (odd samples)
+    pushVoice(&samples[1], num_samples, 2);
 
-        block_ready = true;
-    }
+    // latest coefficient set, taken once per block
+    const LPCFrame32<Order> *frame = lpc_frames.readBuffer();
+
+    uint64_t filter_start = readCycles();
+
+    // synthesizer signal (even samples)
+    if (synthesizeBlock(samples, samples, 2, num_samples, position, frame))
+        statAdd(stat_silent_blocks, 1);
+
+    updateAudioStats(start, filter_start, readCycles());
 }
 
-void TalkBox32::calculateLPCcoefficients(void)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::processBlock(const int32_t *carrier, const int32_t *voice, int32_t *out, int num_samples)
+{
+    uint64_t start = readCycles();
+    int position = buffer_position;
+
+    // voice signal (before filtering, so that out may alias voice)
+    pushVoice(voice, num_samples);
+
+    // latest coefficient set, taken once per block
+    const LPCFrame32<Order> *frame = lpc_frames.readBuffer();
+
+    uint64_t filter_start = readCycles();
+
+    // synthesizer signal
+    if (synthesizeBlock(carrier, out, 1, num_samples, position, frame))
+        statAdd(stat_silent_blocks, 1);
+
+    updateAudioStats(start, filter_start, readCycles());
+}
+
+template <int Order, int BlockLen, int NumAcf>
+bool TalkBox<Order, BlockLen, NumAcf>::analyzeBlock(void)
 {
     int32_t temp32;
     int32_t abs_voice;
+    int32_t max_value;
     int32_t error_power32;
+    bool gated = false;
+    int order = num_coeffs;
 
-    // new input block available?
-    if (block_ready == false)
-        return;
+    if (player)
+        return replayBlock();
+
+    // new input block (hop_size samples) available?
+    int32_t *block_buffer = input_blocks.readBlock();
+    if (block_buffer == 0)
+        return false;
+
+    uint64_t start = readCycles();
 
+    // one pass over the block: voice rms, high pass and max(abs()) of the
+    // high passed block for the normalization in calcAutoCoeff32
     abs_voice = 0;
-    for (int i=0; i<block_length; i++)
+    max_value = 0;
+    for (int i=0; i<hop_size; i++)
     {
         temp32 = block_buffer[i];
 
         // voise rms
-        abs_voice += (labs(temp32) >> n_shift_block);
+        abs_voice += (labs(temp32) >> n_shift_hop);
 
         // high pass
         temp32 = highpass32(temp32, high_pass_coeff, memory_hp);
 
         block_buffer[i] = temp32;
+
+        // as maxAbs32, abs(INT32_MIN) never becomes the maximum
+        temp32 = (int32_t) labs(temp32);
+        if (max_value < temp32)
+            max_value = temp32;
     }
 
     // RMS (FIR)
@@ -152,56 +450,280 @@ void TalkBox32::calculateLPCcoefficients(void)
     else
         voice_rms = 0x7FFFFFFF;
 
-    if (voice_rms < gate_level)     // gate
+    // gate with hysteresis
+    bool reopened = gate.update(voice_rms);
+
+    if (gate.closed)
     {
         voice_rms = 0;
+        gated = true;
     }
 
-    calcAutoCoeff32(acf32[acf_index], num_coeffs+1, block_buffer, block_length);
-
-    // averaging of acfs
-    for (int i = 0; i < num_coeffs + 1; i++)
-        acf32[acf_index][i] = (acf32[0][i] >> 2) + (acf32[1][i] >> 2) + (acf32[2][i] >> 2) + (acf32[3][i] >> 2);
-
-    // smoothing of acf
-    for (int i = 0; i < num_coeffs + 1; i++)
-        acf32_smooth[i] = (((int64_t) acf32_smooth[i] * acf_alpha0) + ((int64_t) acf32[acf_index][i] * acf_alpha1)) >> 31;
+    // the closed gate skips the ACF, the frame keeps the coefficients with
+    // zero gain; the gated blocks count as silence on reopen
+    if (gated == false)
+    {
+        if (reopened)
+        {
+            for (int i=0; i<block_length; i++)
+                window_buffer[i] = 0;
+            sliding_acf.reset();
+            decimator.reset();
+        }
+
+        if (use_sliding_acf)
+        {
+            // rectangular window over the last block_length samples,
+            // updated with the new hop only
+            sliding_acf.push(block_buffer, hop_size);
+            sliding_acf.get(acf32[acf_index]);
+        }
+        else
+        {
+            // block and hop at the analysis rate fs / decimation
+            int decimation = decimator.getFactor();
+            int length = block_length / decimation;
+            int hop = hop_size / decimation;
+
+            if (decimation > 1)
+                max_value = decimator.process(block_buffer, block_buffer, hop_size);
+
+            if (hop < length)
+            {
+                // slide the analysis window by hop
+                memmove(window_buffer, &window_buffer[hop], (length - hop) * sizeof(int32_t));
+                memcpy(&window_buffer[length - hop], block_buffer, hop * sizeof(int32_t));
+
+                // windowing, calcAutoCoeff32 works in place on analysis_buffer,
+                // every decimation-th value of window32 is the shorter hann window
+                max_value = 0;
+                for (int i=0; i<length; i++)
+                {
+                    temp32 = ((int64_t) window_buffer[i] * window32[i * decimation]) >> 31;
+                    analysis_buffer[i] = temp32;
+
+                    temp32 = (int32_t) labs(temp32);
+                    if (max_value < temp32)
+                        max_value = temp32;
+                }
+
+                block_buffer = analysis_buffer;
+            }
+
+            // shift and energy in one more pass, then the lags
+            if (decimation > 1)
+            {
+                int num_lags = decimator.getNumDecimatedLags();
+
+                if (use_q15 && num_lags <= acf16_max_lags)
+                    calcAutoCoeff16(acf32_decimated, num_lags, block_buffer, analysis_buffer16, length, max_value);
+                else
+                    calcAutoCoeff32(acf32_decimated, num_lags, block_buffer, length, num_lags >= fft_acf_min_lags, max_value);
+                decimator.interpolateAcf(acf32_decimated, acf32[acf_index]);
+            }
+            else if (use_q15)
+            {
+                calcAutoCoeff16(acf32[acf_index], num_coeffs + 1, block_buffer, analysis_buffer16, length, max_value);
+            }
+            else
+            {
+                calcAutoCoeff32<num_coeffs + 1, block_length>(acf32[acf_index], block_buffer, max_value);
+            }
+        }
+
+        // the stale ACFs from before the gate closed are replaced by the new one
+        if (reopened)
+        {
+            for (int j = 0; j < num_acf; j++)
+                if (j != acf_index)
+                    for (int i = 0; i < num_coeffs + 1; i++)
+                        acf32[j][i] = acf32[acf_index][i];
+
+            for (int i = 0; i < num_coeffs + 1; i++)
+                acf32_smooth[i] = acf32[acf_index][i];
+        }
+
+        // averaging of acfs
+        for (int i = 0; i < num_coeffs + 1; i++)
+        {
+            temp32 = 0;
+            for (int j = 0; j < num_acf; j++)
+                temp32 += (acf32[j][i] >> n_shift_acf);
+
+            acf32[acf_index][i] = temp32;
+        }
+
+        // smoothing of acf
+        for (int i = 0; i < num_coeffs + 1; i++)
+            acf32_smooth[i] = (((int64_t) acf32_smooth[i] * acf_alpha0) + ((int64_t) acf32[acf_index][i] * acf_alpha1)) >> 31;
+    }
 
     if (voice_rms)
     {
-        error_power32 = durbin32(acf32_smooth, a32_temp, num_coeffs, fractional_digits, k_max);
+        if (use_schur)
+            error_power32 = schur32<num_coeffs>(acf32_smooth, a32_temp, fractional_digits, k_max, k32_temp, &order);
+        else
+            error_power32 = durbin32<num_coeffs>(acf32_smooth, a32_temp, fractional_digits, k_max, k32_temp, &order);
 
         // sqrt(error_power32)
         int32_t log_gain = log32(error_power32);
         log_gain = log_gain >> 1;
         error_gain = exp32(log_gain);
 
-        std::unique_lock<std::mutex> locker(a_coeff_mutex, std::defer_lock);
-        locker.lock();
-
         for (int i = 0; i < num_coeffs; i++)
+        {
             a32[i] = a32_temp[i];
-
-        locker.unlock();
+            k32[i] = k32_temp[i];
+        }
     }
     else
     {
         error_gain = 0;
     }
 
+    // hand a32, k32, error_gain and voice_rms to process() as one set
+    publishFrame();
+
+    analysis_position += hop_size;
+
+    // a recording with a missing frame cannot be replayed, it ends at the
+    // first write error
+    if (recorder && recorder->write(analysis_position, a32, k32, error_gain, voice_rms) == false)
+    {
+        recorder = 0;
+        record_failed = true;
+    }
+
     acf_index++;
     if (acf_index >= num_acf)
         acf_index = 0;
 
-    block_ready = false;
+    input_blocks.pop();
+
+    // statistics
+    if (stats_epoch.load(std::memory_order_relaxed) != analysis_epoch)
+        clearAnalysisStats();
+
+    uint64_t cycles = readCycles() - start;
+
+    statAdd(stat_frames, 1);
+    statAdd(stat_durbin_early_exits, order < num_coeffs);
+    statAdd(stat_gated_blocks, gated);
+    statAdd(stat_analysis_sum, cycles);
+    statMin(stat_analysis_min, cycles);
+    statMax(stat_analysis_max, cycles);
+
+    return true;
 }
 
-void TalkBox32::resetStates(void)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::updateAudioStats(uint64_t start, uint64_t filter_start, uint64_t end)
+{
+    if (stats_epoch.load(std::memory_order_relaxed) != audio_epoch)
+        clearAudioStats();
+
+    statAdd(stat_blocks, 1);
+    statAdd(stat_filter_sum, end - filter_start);
+    statMin(stat_filter_min, end - filter_start);
+    statMax(stat_filter_max, end - filter_start);
+    statMax(stat_callback_max, end - start);
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::clearAudioStats(void)
+{
+    audio_epoch = stats_epoch.load(std::memory_order_relaxed);
+
+    stat_blocks.store(0, std::memory_order_relaxed);
+    stat_filter_sum.store(0, std::memory_order_relaxed);
+    stat_filter_min.store(UINT64_MAX, std::memory_order_relaxed);
+    stat_filter_max.store(0, std::memory_order_relaxed);
+    stat_callback_max.store(0, std::memory_order_relaxed);
+    stat_silent_blocks.store(0, std::memory_order_relaxed);
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::clearAnalysisStats(void)
+{
+    analysis_epoch = stats_epoch.load(std::memory_order_relaxed);
+
+    stat_frames.store(0, std::memory_order_relaxed);
+    stat_durbin_early_exits.store(0, std::memory_order_relaxed);
+    stat_gated_blocks.store(0, std::memory_order_relaxed);
+    stat_analysis_sum.store(0, std::memory_order_relaxed);
+    stat_analysis_min.store(UINT64_MAX, std::memory_order_relaxed);
+    stat_analysis_max.store(0, std::memory_order_relaxed);
+}
+
+template <int Order, int BlockLen, int NumAcf>
+bool TalkBox<Order, BlockLen, NumAcf>::replayBlock(void)
+{
+    // the voice block only marks the time, the frame comes from the file
+    if (input_blocks.readBlock() == 0)
+        return false;
+
+    analysis_position += hop_size;
+
+    // the recorded frame of this hop, silence where the recording has none
+    uint64_t num_frames = player->getNumFrames();
+    while (play_index < num_frames && player->getTimestamp(play_index) < analysis_position)
+        play_index++;
+
+    if (play_index < num_frames && player->getTimestamp(play_index) == analysis_position)
+    {
+        const int32_t *a = player->getA32(play_index);
+        const int32_t *k = player->getK32(play_index);
+
+        for (int i = 0; i < num_coeffs; i++)
+        {
+            a32[i] = a[i];
+            k32[i] = k[i];
+        }
+        error_gain = player->getErrorGain(play_index);
+        voice_rms = player->getVoiceRms(play_index);
+
+        play_index++;
+    }
+    else
+    {
+        error_gain = 0;
+        voice_rms = 0;
+    }
+
+    publishFrame();
+
+    input_blocks.pop();
+
+    if (stats_epoch.load(std::memory_order_relaxed) != analysis_epoch)
+        clearAnalysisStats();
+    statAdd(stat_frames, 1);
+
+    return true;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::publishFrame(void)
+{
+    LPCFrame32<Order> *frame = lpc_frames.writeBuffer();
+
+    for (int i = 0; i < num_coeffs; i++)
+    {
+        frame->a32[i] = a32[i];
+        frame->k32[i] = k32[i];
+    }
+
+    frame->error_gain = error_gain;
+    frame->voice_rms = voice_rms;
+
+    lpc_frames.publish();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::resetStates(void)
 {
     voice_rms = 0;
     error_gain = 0;
-    buffer_position = 0;
-    block_ready = false;
+    this->resetInput();
 
     memory_hp[0] = memory_hp[1] = 0;
 
@@ -211,16 +733,43 @@ void TalkBox32::resetStates(void)
     for (int i=0; i<num_coeffs + 1; i++)
         acf32_smooth[i] = 0;
 
-    for (int i=0; i<num_coeffs; i++)
+    for (int i=0; i<2 * num_coeffs; i++)
         memory_lpc[i] = 0;
+    lpc_position = 0;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice[i] = memory_lattice32[i] = 0;
+    filter_silent = false;
+    gate.closed = false;
+
+    // ramp from silence to the first frame
+    ramp_frame = 0;
+    ramp_count = 0;
+    gain_ramp = 0;
+    for (int i=0; i<num_coeffs; i++)
+        k32_ramp[i] = 0;
+
+    for (int i=0; i<block_length; i++)
+        window_buffer[i] = 0;
+    sliding_acf.reset();
+    decimator.reset();
+
+    analysis_position = 0;
+    play_index = 0;
+
+    publishFrame();
 }
 
-void TalkBox32::setSmoothingTime(float tau)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setSmoothingTime(float tau)
 {
     double alpha;
 
+    smoothing_time = tau;
+
+    // the acf is smoothed once per hop
     if (tau > 0)
-        alpha = 1 - (block_length / ( tau * fs ));
+        alpha = 1 - (hop_size / ( tau * fs ));
     else
         alpha = 0;
 
@@ -231,43 +780,272 @@ void TalkBox32::setSmoothingTime(float tau)
     acf_alpha1 = (int32_t) ((1-alpha) * 0x7FFFFFFF);
 }
 
-void TalkBox32::setGateLevel(float level)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setHopSize(int hop)
 {
-    gate_level = (int32_t) (level * 0x7FFFFFFF);
+    // power of two, 1..block_length, resizes the input ring
+    n_shift_hop = this->setHop(hop, block_length);
+
+    // the decimator needs whole phases per hop
+    if (decimator.getFactor() > hop_size)
+        decimator.setFactor(hop_size);
+
+    setSmoothingTime(smoothing_time);
+
+    resetStates();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+float TalkBox<Order, BlockLen, NumAcf>::getAnalysisLatency(void)
+{
+    // from the center of the analysis window to the end of the next hop,
+    // i.e. assuming the analysis of a hop finishes before the next one is recorded
+    return (float) ((block_length / 2 + hop_size) / fs);
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setGateLevel(float level)
+{
+    // the gate opens at level and closes below level / 2, closed blocks
+    // skip the ACF and the output is zero once the filter has decayed
+    gate.level = (int32_t) (level * 0x7FFFFFFF);
 }
 
-void TalkBox32::setPreemphasis(float fcuttoff)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setPreemphasis(float fcuttoff)
 {
+    // the allpass design turns over at fs / 2, e.g. 20 kHz at 32 kHz
+    if (fcuttoff > 0.49 * fs)
+        fcuttoff = (float) (0.49 * fs);
+
     double ftan = tan(M_PI * fcuttoff / fs);
     high_pass_coeff = (int32_t) ((ftan-1) / (ftan+1) * 0x7FFFFFFF);
 }
 
-int TalkBox32::getNumCoeffs(void)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setLatticeFilter(bool enable)
+{
+    // lattice or direct form all-pole filter, the same filter up to the
+    // separate rounding of a32 and k32, the lattice with 64-bit stage states
+    // not thread safe, call before processing starts
+    use_lattice = enable;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice[i] = memory_lattice32[i] = 0;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setInterpolation(bool enable)
+{
+    // ramps the reflection coefficients and the gain from frame to frame
+    // over one hop, implies the lattice filter, not thread safe
+    use_interpolation = enable;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice[i] = memory_lattice32[i] = 0;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setNarrowLattice(bool enable)
+{
+    // 32-bit stage states in the lattice of setLatticeFilter() and
+    // setInterpolation(), for targets without 64-bit accumulation; the SNR
+    // falls by 6 dB per bit of input level, not thread safe
+    use_narrow_lattice = enable;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice32[i] = 0;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setSlidingAcf(bool enable)
+{
+    // incremental ACF of the last block_length samples with a rectangular
+    // window, O(order) per sample instead of O(order * block_length) per hop,
+    // pays off for hop sizes below block_length / 2, not thread safe
+    use_sliding_acf = enable;
+
+    sliding_acf.reset();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setSchurRecursion(bool enable)
+{
+    // schur32 instead of durbin32 for the LPC analysis, same coefficients
+    // up to rounding, takes effect with the next analysis frame
+    use_schur = enable;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::setDecimation(int factor)
+{
+    // analysis at fs / factor (power of two, 1..decimator_max_factor) behind
+    // a polyphase anti-alias lowpass at 0.45 fs / factor, the ACF is
+    // interpolated back to the lags at fs, so the coefficients and the
+    // synthesis filter stay at the full rate and the envelope is flat above
+    // the cutoff, for 96 kHz and up; not combined with setSlidingAcf(),
+    // not thread safe, call before processing starts (resets the states)
+    if (factor > hop_size)
+        factor = hop_size;
+
+    // the interpolation needs more decimated lags than num_coeffs / factor
+    while (factor > 1 && acf_interpolation_taps + 1 + num_coeffs / factor > block_length / factor)
+        factor /= 2;
+
+    decimator.setFactor(factor);
+
+    resetStates();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+int TalkBox<Order, BlockLen, NumAcf>::getDecimation(void)
+{
+    return decimator.getFactor();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+bool TalkBox<Order, BlockLen, NumAcf>::setQ15Kernels(bool enable)
+{
+    // ACF from a 16-bit block floating point copy of the analysis block
+    // (calcAutoCoeff16), twice the SIMD lanes, the coefficients deviate by
+    // about 2^-15, pays off from about 64 lags; the sliding ACF and the
+    // synthesis filter stay 32 bits. Takes effect with the next frame.
+    // Rejected for more than acf16_max_lags lags, a decimated ACF with
+    // more lags falls back to calcAutoCoeff32
+    if (enable && num_coeffs + 1 > acf16_max_lags)
+        return false;
+
+    use_q15 = enable;
+
+    return true;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::startRecording(LPCFrameSink32 *sink)
+{
+    // hands every analysis frame to sink, from sample 0 on (resets the
+    // states), sink stays owned by the caller and must outlive the
+    // recording, not thread safe, call before processing starts
+    recorder = sink;
+    record_failed = false;
+
+    resetStates();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+bool TalkBox<Order, BlockLen, NumAcf>::stopRecording(void)
+{
+    // the caller completes and closes the sink, false if a frame could not
+    // be written and the recording ended early
+    recorder = 0;
+
+    return record_failed == false;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+bool TalkBox<Order, BlockLen, NumAcf>::startPlayback(LPCFrameSource32 *source)
+{
+    // frames from a recording with the same order and hop size instead of
+    // the analysis of the voice, which may be NULL in processBlock(),
+    // from sample 0 on (resets the states), source stays owned by the
+    // caller, not thread safe
+    if (source->getOrder() != num_coeffs || source->getHopSize() != hop_size ||
+        source->getFractionalDigits() != fractional_digits)
+        return false;
+
+    player = source;
+
+    resetStates();
+
+    return true;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::stopPlayback(void)
+{
+    player = 0;
+
+    resetStates();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+int TalkBox<Order, BlockLen, NumAcf>::getNumCoeffs(void)
 {
     return num_coeffs;
 }
 
-void TalkBox32::getCoefficients(float all_pole_coefficients[])
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::getCoefficients(float all_pole_coefficients[])
 {
     for (int i=0; i<num_coeffs; i++)
         all_pole_coefficients[i] = a32[i] / float(1 << fractional_digits);
 }
 
-float TalkBox32::getPreemphasis(void)
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::getReflectionCoefficients(float reflection_coefficients[])
+{
+    for (int i=0; i<num_coeffs; i++)
+        reflection_coefficients[i] = k32[i] / float(1 << fractional_digits);
+}
+
+template <int Order, int BlockLen, int NumAcf>
+float TalkBox<Order, BlockLen, NumAcf>::getPreemphasis(void)
 {
     return ( high_pass_coeff / float(0x7FFFFFFF) );
 }
 
-float TalkBox32::getErrorGain(void)
+template <int Order, int BlockLen, int NumAcf>
+float TalkBox<Order, BlockLen, NumAcf>::getErrorGain(void)
 {
     return ( error_gain / float(0x7FFFFFFF) );
 }
 
-float TalkBox32::getVoiceGain(void)
+template <int Order, int BlockLen, int NumAcf>
+float TalkBox<Order, BlockLen, NumAcf>::getVoiceGain(void)
 {
     return ( voice_rms / float(0x7FFFFFFF) );
 }
 
+template <int Order, int BlockLen, int NumAcf>
+TalkBoxStats TalkBox<Order, BlockLen, NumAcf>::getStats(void)
+{
+    // lock-free snapshot, every field is consistent on its own
+    TalkBoxStats stats;
+
+    stats.frames = stat_frames.load(std::memory_order_relaxed);
+    stats.overruns = overrun_count.load(std::memory_order_relaxed);
+    stats.durbin_early_exits = stat_durbin_early_exits.load(std::memory_order_relaxed);
+    stats.gated_blocks = stat_gated_blocks.load(std::memory_order_relaxed);
+
+    uint64_t analysis_sum = stat_analysis_sum.load(std::memory_order_relaxed);
+    stats.analysis_cycles_min = stats.frames ? stat_analysis_min.load(std::memory_order_relaxed) : 0;
+    stats.analysis_cycles_avg = stats.frames ? analysis_sum / stats.frames : 0;
+    stats.analysis_cycles_max = stat_analysis_max.load(std::memory_order_relaxed);
+
+    uint64_t blocks = stat_blocks.load(std::memory_order_relaxed);
+    uint64_t filter_sum = stat_filter_sum.load(std::memory_order_relaxed);
+    stats.filter_cycles_min = blocks ? stat_filter_min.load(std::memory_order_relaxed) : 0;
+    stats.filter_cycles_avg = blocks ? filter_sum / blocks : 0;
+    stats.filter_cycles_max = stat_filter_max.load(std::memory_order_relaxed);
+    stats.callback_cycles_max = stat_callback_max.load(std::memory_order_relaxed);
+    stats.silent_blocks = stat_silent_blocks.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBox<Order, BlockLen, NumAcf>::resetStats(void)
+{
+    // the counters are cleared by their writers on their next update
+    stats_epoch.fetch_add(1, std::memory_order_relaxed);
+    overrun_count.store(0, std::memory_order_relaxed);
+}
+
+// configurations from TalkBox32.h
+template class TalkBox<50, 512>;
+template class TalkBox<24, 128>;
+template class TalkBox<100, 2048>;
+
 //--------------------- License ------------------------------------------------
 
 // Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
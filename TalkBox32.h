@@ -2,56 +2,210 @@
 #define _TALK_BOX32
 
 #include <stdint.h>
-#include <mutex>
+#include <atomic>
+
+#include "cacheLine.h"
+#include "talkBoxPipeline.h"
+#include "slidingAutoCoeff32.h"
+#include "decimator32.h"
+#include "calcAutoCoeff16.h"
 
-const int num_coeffs = 50;
-const int block_length = 512;
-const int num_acf = 4;
 const int memory_rms_size = 4;
 const int fractional_digits = 24;
+const int32_t silence_threshold = 1 << 8;  // filter memory treated as decayed
+const int ramp_fraction = 24;               // extra bits of the interpolation ramps
+
+class LPCFrameSink32;
+class LPCFrameSource32;
 
-class TalkBox32
+// coefficient set handed from the analysis to the audio thread, in
+// separate cache lines per buffer of the TripleBuffer
+template <int Order>
+struct alignas(cache_line_size) LPCFrame32
 {
-protected:
-    double fs;
-    int32_t voice_rms;
+    int32_t a32[Order];
+    int32_t k32[Order];
     int32_t error_gain;
-    int32_t buffer_position;
-    int32_t input_buffer0[block_length];
-    int32_t input_buffer1[block_length];
-    int32_t *sample_buffer;
-    int32_t *block_buffer;
-    bool block_ready;
+    int32_t voice_rms;
+};
+
+// snapshot of TalkBox::getStats(), cycles are ticks of readCycles()
+// (cycleCounter.h), the timing of the audio thread covers processBlock()
+struct TalkBoxStats
+{
+    uint64_t frames;                // analysis frames computed
+    uint64_t overruns;              // input blocks overwritten before the analysis
+    uint64_t durbin_early_exits;    // frames with |k| > k_max in durbin32/schur32
+    uint64_t gated_blocks;          // blocks with the gate closed
+    uint64_t silent_blocks;         // processBlock() calls that output zeros
+    uint64_t analysis_cycles_min;   // per analysis frame
+    uint64_t analysis_cycles_avg;
+    uint64_t analysis_cycles_max;
+    uint64_t filter_cycles_min;     // synthesis of one processBlock() call
+    uint64_t filter_cycles_avg;
+    uint64_t filter_cycles_max;
+    uint64_t callback_cycles_max;   // one processBlock() call
+};
+
+/*---------------------------------------------------------------------------*\
+|   Order:    number of LPC coefficients                                      |
+|   BlockLen: analysis block length in samples, power of two                  |
+|   NumAcf:   number of block ACFs that are averaged, power of two            |
+|                                                                             |
+|   The member functions are defined in TalkBox32.cpp and instantiated there  |
+|   for the configurations below; add a line there for other ones. Voice      |
+|   input, frame handoff and analysis thread are in talkBoxPipeline.h.        |
+\*---------------------------------------------------------------------------*/
+
+template <int Order, int BlockLen, int NumAcf = 4>
+class TalkBox : public TalkBoxPipeline<int32_t, LPCFrame32<Order> >
+{
+public:
+    typedef TalkBoxPipeline<int32_t, LPCFrame32<Order> > Pipeline;
+
+    static const int num_coeffs = Order;
+    static const int block_length = BlockLen;
+    static const int num_acf = NumAcf;
+
+    static_assert((BlockLen & (BlockLen - 1)) == 0, "BlockLen must be a power of two");
+    static_assert((NumAcf & (NumAcf - 1)) == 0, "NumAcf must be a power of two");
+
+protected:
+    using Pipeline::fs;
+    using Pipeline::hop_size;
+    using Pipeline::buffer_position;
+    using Pipeline::sample_buffer;
+    using Pipeline::input_blocks;
+    using Pipeline::lpc_frames;
+    using Pipeline::overrun_count;
+    using Pipeline::pushBlock;
+
+    // configuration, written by the setters before processing starts,
+    // read by both threads
     int16_t n_shift_memory;
-    int16_t n_shift_block;
+    int16_t n_shift_hop;
+    int16_t n_shift_acf;
+    float smoothing_time;
     int32_t high_pass_coeff;
-    int32_t memory_hp[2];
-    int32_t memory_rms32[memory_rms_size];
     int32_t acf_alpha0;
     int32_t acf_alpha1;
-    int32_t gate_level;
+    bool use_lattice;
+    bool use_narrow_lattice;
+    bool use_interpolation;
+    bool use_sliding_acf;
+    bool use_schur;
+    bool use_q15;
+
+    // audio thread, the state touched per sample first
+    alignas(cache_line_size) int lpc_position;
+    const LPCFrame32<Order> *ramp_frame;
+    int ramp_count;
+    int32_t gain_ramp;
+    int64_t gain64_ramp;            // gain_ramp with ramp_fraction more bits
+    int64_t gain64_step;
+    uint32_t audio_epoch;
+    bool filter_silent;             // memory cleared, no voiced frame since
+    alignas(cache_line_size) int32_t memory_lpc[2 * num_coeffs];
+    alignas(cache_line_size) int64_t memory_lattice[num_coeffs];
+    alignas(cache_line_size) int32_t memory_lattice32[num_coeffs];
+    alignas(cache_line_size) int32_t k32_ramp[num_coeffs];
+    alignas(cache_line_size) int64_t k64_ramp[num_coeffs];
+    alignas(cache_line_size) int64_t k64_step[num_coeffs];
+    alignas(cache_line_size) std::atomic<uint64_t> stat_blocks;
+    std::atomic<uint64_t> stat_filter_sum;
+    std::atomic<uint64_t> stat_filter_min;
+    std::atomic<uint64_t> stat_filter_max;
+    std::atomic<uint64_t> stat_callback_max;
+    std::atomic<uint64_t> stat_silent_blocks;
+
+    alignas(cache_line_size) std::atomic<uint32_t> stats_epoch;  // resetStats() is carried out by the writers
+
+    // analysis thread
+    alignas(cache_line_size) int32_t voice_rms;
+    int32_t error_gain;
+    int32_t memory_hp[2];
+    int32_t memory_rms32[memory_rms_size];
     int16_t acf_index;
-    int32_t acf32[num_acf][num_coeffs + 1];
-    int32_t acf32_smooth[num_coeffs + 1];
-    int32_t a32_temp[num_coeffs];
-    int32_t a32[num_coeffs];
-    int32_t memory_lpc[num_coeffs];
-    std::mutex a_coeff_mutex;
+    NoiseGate<int32_t> gate;
+    uint32_t analysis_epoch;
+    std::atomic<uint64_t> stat_frames;
+    std::atomic<uint64_t> stat_durbin_early_exits;
+    std::atomic<uint64_t> stat_gated_blocks;
+    std::atomic<uint64_t> stat_analysis_sum;
+    std::atomic<uint64_t> stat_analysis_min;
+    std::atomic<uint64_t> stat_analysis_max;
+    alignas(cache_line_size) int32_t acf32[num_acf][num_coeffs + 1];
+    alignas(cache_line_size) int32_t acf32_smooth[num_coeffs + 1];
+    alignas(cache_line_size) int32_t a32_temp[num_coeffs];
+    alignas(cache_line_size) int32_t a32[num_coeffs];
+    alignas(cache_line_size) int32_t k32_temp[num_coeffs];
+    alignas(cache_line_size) int32_t k32[num_coeffs];
+    alignas(cache_line_size) int32_t window32[block_length];
+    alignas(cache_line_size) int32_t window_buffer[block_length];
+    alignas(cache_line_size) int32_t analysis_buffer[block_length];
+    alignas(cache_line_size) int16_t analysis_buffer16[block_length];
+    alignas(cache_line_size) int32_t acf32_decimated[num_coeffs + acf_interpolation_taps + 1];
+    SlidingAutoCoeff32<num_coeffs + 1, block_length> sliding_acf;
+    Decimator32<num_coeffs + 1, block_length> decimator;
+    uint64_t analysis_position;         // samples analyzed
+    LPCFrameSink32 *recorder;
+    bool record_failed;             // a write to recorder failed, recording stopped
+    LPCFrameSource32 *player;
+    uint64_t play_index;
+
+    bool analyzeBlock(void) override;
+    bool replayBlock(void);
+    void publishFrame(void);
+    void startRamp(const LPCFrame32<Order> *frame);
+    int32_t synthesize(int32_t carrierSample, const LPCFrame32<Order> *frame);
+    bool silentBlock(const LPCFrame32<Order> *frame);
+    void updateSilence(const LPCFrame32<Order> *frame);
+    bool synthesizeBlock(const int32_t *carrier, int32_t *out, int stride, int num_samples,
+                         int position, const LPCFrame32<Order> *frame);
+    void clearAudioStats(void);
+    void clearAnalysisStats(void);
+    void updateAudioStats(uint64_t start, uint64_t filter_start, uint64_t end);
 
 public:
-    TalkBox32(double fs);
-    ~TalkBox32(void);
+    TalkBox(double fs, int num_blocks = 2);
+    ~TalkBox(void);
     void process(int32_t samples[]);
-    void calculateLPCcoefficients(void);
+    void processBlock(int32_t samples[], int num_samples);
+    void processBlock(const int32_t *carrier, const int32_t *voice, int32_t *out, int num_samples);
+    using Pipeline::pushVoice;
+    using Pipeline::getFrame;
+    using Pipeline::calculateLPCcoefficients;
+    using Pipeline::stopAnalysisThread;
     void resetStates(void);
     void setSmoothingTime(float tau);
+    void setHopSize(int hop);
+    float getAnalysisLatency(void);
     void setGateLevel(float level);
     void setPreemphasis(float fcuttoff);
+    void setLatticeFilter(bool enable);
+    void setInterpolation(bool enable);
+    void setNarrowLattice(bool enable);
+    void setSlidingAcf(bool enable);
+    void setSchurRecursion(bool enable);
+    void setDecimation(int factor);
+    int  getDecimation(void);
+    bool setQ15Kernels(bool enable);
+    void startRecording(LPCFrameSink32 *sink);
+    bool stopRecording(void);
+    bool startPlayback(LPCFrameSource32 *source);
+    void stopPlayback(void);
     int  getNumCoeffs(void);
     void getCoefficients(float all_pole_coefficients[]);
+    void getReflectionCoefficients(float reflection_coefficients[]);
     float getPreemphasis(void);
     float getErrorGain(void);
     float getVoiceGain(void);
+    TalkBoxStats getStats(void);
+    void resetStats(void);
 };
 
+typedef TalkBox<50, 512> TalkBox32;             // default configuration
+typedef TalkBox<24, 128> TalkBox32LowLatency;   // live vocals
+typedef TalkBox<100, 2048> TalkBox32HighOrder;  // offline rendering
+
 #endif  // _TALK_BOX32
@@ -0,0 +1,233 @@
+#include <string.h>
+
+#include "TalkBoxBank32.h"
+#include "lpcFilter32.h"
+
+template <int Order, int BlockLen, int NumAcf>
+TalkBoxBank<Order, BlockLen, NumAcf>::TalkBoxBank(double fs, int num_voices, int num_blocks)
+{
+    this->num_voices = num_voices;
+
+    // padding voices have zero coefficients and gains
+    stride = (num_voices + lpc_bank_lanes - 1) / lpc_bank_lanes * lpc_bank_lanes;
+
+    voices = new Voice*[num_voices];
+    frames = new const LPCFrame32<Order>*[num_voices];
+
+    for (int v = 0; v < num_voices; v++)
+        voices[v] = new Voice(fs, num_blocks);
+
+    a32 = new int32_t[Order * stride];
+    error_gain = new int32_t[stride];
+    voice_rms = new int32_t[stride];
+    memory_lpc = new int32_t[2 * Order * stride];
+    input_frame = new int32_t[stride];
+    output_frame = new int32_t[stride];
+    voice_silent = new bool[num_voices];
+    hop_left = new int[num_voices];
+
+    for (int i = 0; i < Order * stride; i++)
+        a32[i] = 0;
+
+    for (int v = 0; v < stride; v++)
+        input_frame[v] = 0;
+
+    resetStates();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+TalkBoxBank<Order, BlockLen, NumAcf>::~TalkBoxBank(void)
+{
+    for (int v = 0; v < num_voices; v++)
+        delete voices[v];
+
+    delete[] voices;
+    delete[] frames;
+    delete[] a32;
+    delete[] error_gain;
+    delete[] voice_rms;
+    delete[] memory_lpc;
+    delete[] input_frame;
+    delete[] output_frame;
+    delete[] voice_silent;
+    delete[] hop_left;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBoxBank<Order, BlockLen, NumAcf>::processBlock(const int32_t *carrier, const int32_t *voice, int32_t *out, int num_samples)
+{
+    int32_t temp32;
+    int n;
+
+    // voice signals to the analysis of each voice
+    for (int v = 0; v < num_voices; v++)
+    {
+        hop_left[v] = voices[v]->getHopSize() - voices[v]->getHopPosition();
+        voices[v]->pushVoice(&voice[v], num_samples, num_voices);
+    }
+
+    updateCoefficients();
+
+    // runs that end at the hop boundaries of any voice, where TalkBox
+    // checks the silence of that voice
+    for (int i0 = 0; i0 < num_samples; i0 += n)
+    {
+        n = num_samples - i0;
+        for (int v = 0; v < num_voices; v++)
+            if (n > hop_left[v])
+                n = hop_left[v];
+
+        // all filters decayed and no voice with gain: zero output
+        if (num_silent == num_voices)
+        {
+            memset(&out[i0 * num_voices], 0, n * num_voices * sizeof(int32_t));
+        }
+        else
+        {
+            for (int i = i0; i < i0 + n; i++)
+            {
+                // synthesizer signal * gain * voice_rms
+                for (int v = 0; v < num_voices; v++)
+                {
+                    temp32 = ((int64_t) error_gain[v] * carrier[i * num_voices + v]) >> 31;
+                    input_frame[v] = ((int64_t) voice_rms[v] * temp32) >> 31;
+                }
+
+                // all-pole filters of all voices
+                lpcFilterBank32(input_frame, output_frame, a32, memory_lpc, &lpc_position, Order, num_voices, stride, fractional_digits);
+
+                memcpy(&out[i * num_voices], output_frame, num_voices * sizeof(int32_t));
+            }
+        }
+
+        for (int v = 0; v < num_voices; v++)
+        {
+            hop_left[v] -= n;
+
+            if (hop_left[v] == 0)
+            {
+                updateSilence(v);
+                hop_left[v] = voices[v]->getHopSize();
+            }
+        }
+    }
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBoxBank<Order, BlockLen, NumAcf>::updateCoefficients(void)
+{
+    // transpose only the coefficient sets that were published since the last call
+    for (int v = 0; v < num_voices; v++)
+    {
+        const LPCFrame32<Order> *frame = voices[v]->getFrame();
+
+        if (frame == frames[v])
+            continue;
+
+        for (int k = 0; k < Order; k++)
+            a32[k * stride + v] = frame->a32[k];
+
+        error_gain[v] = frame->error_gain;
+        voice_rms[v] = frame->voice_rms;
+
+        frames[v] = frame;
+
+        // as TalkBox::silentBlock(), a voiced frame ends the silence
+        if (voice_silent[v] && frame->error_gain != 0 && frame->voice_rms != 0)
+        {
+            voice_silent[v] = false;
+            num_silent--;
+        }
+    }
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBoxBank<Order, BlockLen, NumAcf>::updateSilence(int v)
+{
+    // as TalkBox::updateSilence() for voice v at its hop boundary: the filter
+    // memory of a voice without gain is cleared once it has decayed below
+    // silence_threshold, with zero memory and input its column of the bank
+    // filter outputs zeros
+    if (voice_silent[v] || (error_gain[v] != 0 && voice_rms[v] != 0))
+        return;
+
+    bool decayed = true;
+    for (int i = 0; i < 2 * Order && decayed; i++)
+        decayed = memory_lpc[i * stride + v] <= silence_threshold && memory_lpc[i * stride + v] >= -silence_threshold;
+
+    if (decayed == false)
+        return;
+
+    for (int i = 0; i < 2 * Order; i++)
+        memory_lpc[i * stride + v] = 0;
+
+    voice_silent[v] = true;
+    num_silent++;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBoxBank<Order, BlockLen, NumAcf>::calculateLPCcoefficients(void)
+{
+    // all ready blocks of all voices in one pass
+    for (int v = 0; v < num_voices; v++)
+        voices[v]->calculateLPCcoefficients();
+}
+
+template <int Order, int BlockLen, int NumAcf>
+void TalkBoxBank<Order, BlockLen, NumAcf>::resetStates(void)
+{
+    for (int v = 0; v < num_voices; v++)
+    {
+        voices[v]->resetStates();
+        frames[v] = 0;
+        voice_silent[v] = false;
+    }
+    num_silent = 0;
+
+    for (int v = 0; v < stride; v++)
+        error_gain[v] = voice_rms[v] = 0;
+
+    for (int i = 0; i < 2 * Order * stride; i++)
+        memory_lpc[i] = 0;
+    lpc_position = 0;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+int TalkBoxBank<Order, BlockLen, NumAcf>::getNumVoices(void)
+{
+    return num_voices;
+}
+
+template <int Order, int BlockLen, int NumAcf>
+typename TalkBoxBank<Order, BlockLen, NumAcf>::Voice *TalkBoxBank<Order, BlockLen, NumAcf>::getVoice(int index)
+{
+    return voices[index];
+}
+
+// configurations from TalkBoxBank32.h
+template class TalkBoxBank<50, 512>;
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
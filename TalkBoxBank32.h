@@ -0,0 +1,61 @@
+#ifndef _TALK_BOX_BANK32
+#define _TALK_BOX_BANK32
+
+#include <stdint.h>
+
+#include "TalkBox32.h"
+
+/*---------------------------------------------------------------------------*\
+|   Bank of TalkBox voices with a common all-pole filter                      |
+|                                                                             |
+|   Every voice has its own analysis (a TalkBox instance), but the synthesis  |
+|   filters of all voices run together on structure-of-arrays state, so       |
+|   that one SIMD vector holds the same coefficient of several voices.        |
+|                                                                             |
+|   Signals are interleaved by voice: carrier[i * num_voices + v] is sample   |
+|   i of voice v. The output of each voice is bit-exact with a separate       |
+|   TalkBox fed with the same signals, including the clearing of a decayed    |
+|   filter while the frame has no gain; once all voices are silent, blocks    |
+|   are output as zeros without filtering.                                    |
+\*---------------------------------------------------------------------------*/
+
+template <int Order, int BlockLen, int NumAcf = 4>
+class TalkBoxBank
+{
+public:
+    typedef TalkBox<Order, BlockLen, NumAcf> Voice;
+
+protected:
+    int num_voices;
+    int stride;                         // num_voices rounded up to lpc_bank_lanes
+    Voice **voices;
+    const LPCFrame32<Order> **frames;   // coefficient set in use per voice
+    int32_t *a32;                       // a32[k * stride + v]
+    int32_t *error_gain;
+    int32_t *voice_rms;
+    int32_t *memory_lpc;                // 2 * Order rows of stride voices
+    int lpc_position;
+    int32_t *input_frame;
+    int32_t *output_frame;
+    bool *voice_silent;                 // memory cleared, no voiced frame since
+    int num_silent;
+    int *hop_left;                      // samples to the next hop boundary per voice
+
+    void updateCoefficients(void);
+    void updateSilence(int v);
+
+public:
+    TalkBoxBank(double fs, int num_voices, int num_blocks = 2);
+    ~TalkBoxBank(void);
+    TalkBoxBank(const TalkBoxBank &) = delete;     // owns its arrays
+    TalkBoxBank &operator=(const TalkBoxBank &) = delete;
+    void processBlock(const int32_t *carrier, const int32_t *voice, int32_t *out, int num_samples);
+    void calculateLPCcoefficients(void);
+    void resetStates(void);
+    int  getNumVoices(void);
+    Voice *getVoice(int index);
+};
+
+typedef TalkBoxBank<50, 512> TalkBoxBank32;
+
+#endif  // _TALK_BOX_BANK32
@@ -0,0 +1,608 @@
+#include <math.h>
+#include <string.h>
+
+#include "TalkBoxFloat.h"
+#include "lpcFloat.h"
+
+#define M_PI    3.14159265358979323846
+
+const double k_max = 0.99;
+
+// keeps the recursive states away from denormal numbers in silence:
+// added to the input of the all-pole filter, which gets a dc offset of
+// denormal_offset / A(1) far below the resolution of any audio format,
+// and added to and subtracted from the analysis states, which flushes
+// values below denormal_offset * epsilon to zero
+const double denormal_offset = 1e-18;
+
+// filter memory treated as decayed, as silence_threshold in TalkBox32.h
+const double silence_level = 256. / 2147483648.;
+
+/* a tunable high-pass filter based on a first order allpass, as highpass32 */
+
+template <class T>
+inline T highpassFloat(T in, T coeff, T *mem)
+{
+    T out;
+
+    in = in * (T) 0.5;
+
+    out = coeff * (in - mem[1]) + mem[0];
+
+    mem[0] = in;                    // non-recursive state
+    mem[1] = out;                   // recursive state
+
+    return (in - out);
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+TalkBoxFloat<T, Order, BlockLen, NumAcf>::TalkBoxFloat(double fs, int num_blocks) : Pipeline(fs, num_blocks)
+{
+    // non-overlapping blocks
+    hop_size = block_length;
+
+    // parameter for smoothing
+    setSmoothingTime(0.03f);
+
+    // gate off
+    gate.level = 0;
+
+    // analysis window for overlapping blocks, periodic hann
+    for (int i=0; i<block_length; i++)
+        window[i] = (T) (0.5 - 0.5 * cos(2 * M_PI * i / block_length));
+
+    // high pass design
+    setPreemphasis(20000.f);
+
+    // direct form synthesis filter, frames switched without interpolation
+    use_lattice = false;
+    use_interpolation = false;
+
+    // set states to null
+    for (int i=0; i<num_coeffs; i++)
+        a[i] = k[i] = 0;
+
+    for (int j=0; j<num_acf; j++)
+        for (int i=0; i<num_coeffs + 1; i++)
+            acf[j][i] = 0;
+
+    acf_index = 0;
+
+    // allocates the input ring and resets the states
+    setHopSize(block_length);
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+TalkBoxFloat<T, Order, BlockLen, NumAcf>::~TalkBoxFloat(void)
+{
+    stopAnalysisThread();
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::startRamp(const LPCFrameFloat<T, Order> *frame)
+{
+    ramp_frame = frame;
+
+    // reach the new frame when the next one is due
+    ramp_count = hop_size;
+    gain_step = (frame->error_gain * frame->voice_rms - gain_ramp) / hop_size;
+
+    for (int i = 0; i < num_coeffs; i++)
+        k_step[i] = (frame->k[i] - k_ramp[i]) / hop_size;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+inline T TalkBoxFloat<T, Order, BlockLen, NumAcf>::synthesize(T carrierSample, const LPCFrameFloat<T, Order> *frame)
+{
+    if (use_interpolation)
+    {
+        if (frame != ramp_frame)
+            startRamp(frame);
+
+        // linear ramp of the reflection coefficients and the gain
+        if (ramp_count > 0)
+        {
+            ramp_count--;
+
+            if (ramp_count > 0)
+            {
+                for (int i = 0; i < num_coeffs; i++)
+                    k_ramp[i] += k_step[i];
+                gain_ramp += gain_step;
+            }
+            else
+            {
+                for (int i = 0; i < num_coeffs; i++)
+                    k_ramp[i] = frame->k[i];
+                gain_ramp = frame->error_gain * frame->voice_rms;
+            }
+        }
+
+        T temp = gain_ramp * carrierSample + (T) denormal_offset;
+
+        return latticeFilterFloat(temp, k_ramp, memory_lattice, num_coeffs);
+    }
+
+    // input * gain * voice_rms
+    T temp = frame->error_gain * frame->voice_rms * carrierSample + (T) denormal_offset;
+
+    // all-pole filter
+    if (use_lattice)
+        return latticeFilterFloat(temp, frame->k, memory_lattice, num_coeffs);
+
+    return lpcFilterCircularFloat(temp, frame->a, memory_lpc, &lpc_position, num_coeffs);
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+inline bool TalkBoxFloat<T, Order, BlockLen, NumAcf>::silentBlock(const LPCFrameFloat<T, Order> *frame)
+{
+    // as TalkBox::silentBlock(), zero output without filtering until the
+    // next voiced frame once the filter has decayed
+    if (filter_silent == false)
+        return false;
+
+    if (frame->error_gain != 0 && frame->voice_rms != 0)
+    {
+        filter_silent = false;
+        return false;
+    }
+
+    // with zero memory and input the ramp to this frame is silent, too
+    if (use_interpolation && frame != ramp_frame)
+    {
+        ramp_frame = frame;
+        ramp_count = 0;
+        gain_ramp = 0;
+        for (int i = 0; i < num_coeffs; i++)
+            k_ramp[i] = frame->k[i];
+    }
+
+    return true;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::updateSilence(const LPCFrameFloat<T, Order> *frame)
+{
+    // as TalkBox::updateSilence(), the memory decays towards the dc offset
+    // of denormal_offset and is cleared below silence_level
+    if (frame->error_gain != 0 && frame->voice_rms != 0)
+        return;
+
+    if (use_interpolation && (ramp_count > 0 || gain_ramp != 0))
+        return;
+
+    if (use_interpolation || use_lattice)
+    {
+        for (int i = 0; i < num_coeffs; i++)
+            if (fabs(memory_lattice[i]) > (T) silence_level)
+                return;
+    }
+    else
+    {
+        for (int i = 0; i < 2 * num_coeffs; i++)
+            if (fabs(memory_lpc[i]) > (T) silence_level)
+                return;
+    }
+
+    for (int i = 0; i < 2 * num_coeffs; i++)
+        memory_lpc[i] = 0;
+    lpc_position = 0;
+
+    for (int i = 0; i < num_coeffs; i++)
+        memory_lattice[i] = 0;
+
+    filter_silent = true;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::synthesizeBlock(const T *carrier, T *out, int stride, int num_samples,
+                                                               int position, const LPCFrameFloat<T, Order> *frame)
+{
+    int n;
+
+    // runs that end at the hop boundaries, as TalkBox::synthesizeBlock()
+    for (int i = 0; i < num_samples; i += n)
+    {
+        n = hop_size - position;
+        if (n > num_samples - i)
+            n = num_samples - i;
+
+        if (silentBlock(frame))
+        {
+            for (int j = i; j < i + n; j++)
+                out[j * stride] = 0;
+        }
+        else
+        {
+            for (int j = i; j < i + n; j++)
+                out[j * stride] = synthesize(carrier[j * stride], frame);
+        }
+
+        position += n;
+
+        if (position >= hop_size)
+        {
+            updateSilence(frame);
+            position = 0;
+        }
+    }
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::process(T samples[])
+{
+    // latest coefficient set, never blocks
+    const LPCFrameFloat<T, Order> *frame = lpc_frames.readBuffer();
+
+    // synthesizer signal * gain * voice_rms, all-pole filter
+    if (silentBlock(frame))
+        samples[0] = 0;
+    else
+        samples[0] = synthesize(samples[0], frame);
+
+    // voice signal
+    sample_buffer[buffer_position++] = samples[1];
+
+    if (buffer_position >= hop_size)
+    {
+        updateSilence(frame);
+        pushBlock();
+    }
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::processBlock(T samples[], int num_samples)
+{
+    int position = buffer_position;
+
+    // voice signal (odd samples)
+    pushVoice(&samples[1], num_samples, 2);
+
+    // latest coefficient set, taken once per block
+    const LPCFrameFloat<T, Order> *frame = lpc_frames.readBuffer();
+
+    // synthesizer signal (even samples)
+    synthesizeBlock(samples, samples, 2, num_samples, position, frame);
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::processBlock(const T *carrier, const T *voice, T *out, int num_samples)
+{
+    int position = buffer_position;
+
+    // voice signal (before filtering, so that out may alias voice)
+    pushVoice(voice, num_samples);
+
+    // latest coefficient set, taken once per block
+    const LPCFrameFloat<T, Order> *frame = lpc_frames.readBuffer();
+
+    // synthesizer signal
+    synthesizeBlock(carrier, out, 1, num_samples, position, frame);
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+bool TalkBoxFloat<T, Order, BlockLen, NumAcf>::analyzeBlock(void)
+{
+    T abs_voice;
+
+    // new input block (hop_size samples) available?
+    T *block_buffer = input_blocks.readBlock();
+    if (block_buffer == 0)
+        return false;
+
+    abs_voice = 0;
+    for (int i=0; i<hop_size; i++)
+    {
+        // voice rms
+        abs_voice += fabs(block_buffer[i]);
+
+        // high pass
+        block_buffer[i] = highpassFloat(block_buffer[i], high_pass_coeff, memory_hp);
+    }
+
+    // flushes the decaying high pass states in silence
+    memory_hp[0] = (memory_hp[0] + (T) denormal_offset) - (T) denormal_offset;
+    memory_hp[1] = (memory_hp[1] + (T) denormal_offset) - (T) denormal_offset;
+
+    // RMS (FIR)
+    for (int i = memory_rms_size - 1; i > 0; i--)
+        memory_rms[i] = memory_rms[i - 1];
+    memory_rms[0] = abs_voice / hop_size;
+
+    voice_rms = 0;
+    for (int i = 0; i < memory_rms_size; i++)
+        voice_rms += memory_rms[i];
+
+    // mean * 4, limited to 1 as in TalkBox
+    voice_rms = voice_rms * 4 / memory_rms_size;
+    if (voice_rms > 1)
+        voice_rms = 1;
+
+    // gate with hysteresis
+    bool reopened = gate.update(voice_rms);
+
+    if (gate.closed)
+        voice_rms = 0;
+
+    // the closed gate skips the ACF, the frame keeps the coefficients with
+    // zero gain; the gated blocks count as silence on reopen
+    if (gate.closed == false)
+    {
+        if (reopened)
+        {
+            for (int i=0; i<block_length; i++)
+                window_buffer[i] = 0;
+        }
+
+        if (hop_size < block_length)
+        {
+            // slide the analysis window by hop_size
+            memmove(window_buffer, &window_buffer[hop_size], (block_length - hop_size) * sizeof(T));
+            memcpy(&window_buffer[block_length - hop_size], block_buffer, hop_size * sizeof(T));
+
+            for (int i=0; i<block_length; i++)
+                analysis_buffer[i] = window_buffer[i] * window[i];
+
+            block_buffer = analysis_buffer;
+        }
+
+        calcAutoCoeffFloat(acf[acf_index], num_coeffs + 1, block_buffer, block_length);
+
+        // the stale ACFs from before the gate closed are replaced by the new one
+        if (reopened)
+        {
+            for (int j = 0; j < num_acf; j++)
+                if (j != acf_index)
+                    for (int i = 0; i < num_coeffs + 1; i++)
+                        acf[j][i] = acf[acf_index][i];
+
+            for (int i = 0; i < num_coeffs + 1; i++)
+                acf_smooth[i] = acf[acf_index][i];
+        }
+
+        // averaging of acfs
+        for (int i = 0; i < num_coeffs + 1; i++)
+        {
+            T sum = 0;
+            for (int j = 0; j < num_acf; j++)
+                sum += acf[j][i];
+
+            acf[acf_index][i] = sum / num_acf;
+        }
+
+        // smoothing of acf, values that decay towards zero in silence are flushed
+        for (int i = 0; i < num_coeffs + 1; i++)
+        {
+            T temp = acf_smooth[i] * acf_alpha + acf[acf_index][i] * (1 - acf_alpha);
+            acf_smooth[i] = (temp + (T) denormal_offset) - (T) denormal_offset;
+        }
+    }
+
+    if (voice_rms > 0)
+    {
+        T error_power = durbinFloat<num_coeffs>(acf_smooth, a_temp, k_temp, (T) k_max);
+
+        error_gain = sqrt(error_power > 0 ? error_power : 0);
+
+        for (int i = 0; i < num_coeffs; i++)
+        {
+            a[i] = a_temp[i];
+            k[i] = k_temp[i];
+        }
+    }
+    else
+    {
+        error_gain = 0;
+    }
+
+    // hand a, k, error_gain and voice_rms to process() as one set
+    publishFrame();
+
+    acf_index++;
+    if (acf_index >= num_acf)
+        acf_index = 0;
+
+    input_blocks.pop();
+
+    return true;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::publishFrame(void)
+{
+    LPCFrameFloat<T, Order> *frame = lpc_frames.writeBuffer();
+
+    for (int i = 0; i < num_coeffs; i++)
+    {
+        frame->a[i] = a[i];
+        frame->k[i] = k[i];
+    }
+
+    frame->error_gain = error_gain;
+    frame->voice_rms = voice_rms;
+
+    lpc_frames.publish();
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::resetStates(void)
+{
+    voice_rms = 0;
+    error_gain = 0;
+    this->resetInput();
+
+    memory_hp[0] = memory_hp[1] = 0;
+
+    for (int i=0; i<memory_rms_size; i++)
+        memory_rms[i] = 0;
+
+    for (int i=0; i<num_coeffs + 1; i++)
+        acf_smooth[i] = 0;
+
+    for (int i=0; i<2 * num_coeffs; i++)
+        memory_lpc[i] = 0;
+    lpc_position = 0;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice[i] = 0;
+    filter_silent = false;
+    gate.closed = false;
+
+    // ramp from silence to the first frame
+    ramp_frame = 0;
+    ramp_count = 0;
+    gain_ramp = 0;
+    for (int i=0; i<num_coeffs; i++)
+        k_ramp[i] = 0;
+
+    for (int i=0; i<block_length; i++)
+        window_buffer[i] = 0;
+
+    publishFrame();
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::setSmoothingTime(float tau)
+{
+    double alpha;
+
+    smoothing_time = tau;
+
+    // the acf is smoothed once per hop
+    if (tau > 0)
+        alpha = 1 - (hop_size / ( tau * fs ));
+    else
+        alpha = 0;
+
+    if (alpha < 0)
+        alpha = 0;
+
+    acf_alpha = (T) alpha;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::setHopSize(int hop)
+{
+    // power of two, 1..block_length, resizes the input ring
+    this->setHop(hop, block_length);
+
+    setSmoothingTime(smoothing_time);
+
+    resetStates();
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+float TalkBoxFloat<T, Order, BlockLen, NumAcf>::getAnalysisLatency(void)
+{
+    return (float) ((block_length / 2 + hop_size) / fs);
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::setGateLevel(float level)
+{
+    // the gate opens at level and closes below level / 2, closed blocks
+    // skip the ACF and the output is zero once the filter has decayed
+    gate.level = level;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::setPreemphasis(float fcuttoff)
+{
+    // the allpass design turns over at fs / 2, e.g. 20 kHz at 32 kHz
+    if (fcuttoff > 0.49 * fs)
+        fcuttoff = (float) (0.49 * fs);
+
+    double ftan = tan(M_PI * fcuttoff / fs);
+    high_pass_coeff = (T) ((ftan-1) / (ftan+1));
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::setLatticeFilter(bool enable)
+{
+    // not thread safe, call before processing starts
+    use_lattice = enable;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice[i] = 0;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::setInterpolation(bool enable)
+{
+    // implies the lattice filter, not thread safe
+    use_interpolation = enable;
+
+    for (int i=0; i<num_coeffs; i++)
+        memory_lattice[i] = 0;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+int TalkBoxFloat<T, Order, BlockLen, NumAcf>::getNumCoeffs(void)
+{
+    return num_coeffs;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::getCoefficients(float all_pole_coefficients[])
+{
+    for (int i=0; i<num_coeffs; i++)
+        all_pole_coefficients[i] = (float) a[i];
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+void TalkBoxFloat<T, Order, BlockLen, NumAcf>::getReflectionCoefficients(float reflection_coefficients[])
+{
+    for (int i=0; i<num_coeffs; i++)
+        reflection_coefficients[i] = (float) k[i];
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+float TalkBoxFloat<T, Order, BlockLen, NumAcf>::getPreemphasis(void)
+{
+    return (float) high_pass_coeff;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+float TalkBoxFloat<T, Order, BlockLen, NumAcf>::getErrorGain(void)
+{
+    return (float) error_gain;
+}
+
+template <class T, int Order, int BlockLen, int NumAcf>
+float TalkBoxFloat<T, Order, BlockLen, NumAcf>::getVoiceGain(void)
+{
+    return (float) voice_rms;
+}
+
+// configurations from TalkBox32.h
+template class TalkBoxFloat<float, 50, 512>;
+template class TalkBoxFloat<float, 24, 128>;
+template class TalkBoxFloat<float, 100, 2048>;
+template class TalkBoxFloat<double, 50, 512>;
+template class TalkBoxFloat<double, 24, 128>;
+template class TalkBoxFloat<double, 100, 2048>;
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,124 @@
+#ifndef _TALK_BOX_FLOAT
+#define _TALK_BOX_FLOAT
+
+#include <stdint.h>
+
+#include "talkBoxPipeline.h"
+
+// coefficient set handed from the analysis to the audio thread
+template <class T, int Order>
+struct LPCFrameFloat
+{
+    T a[Order];
+    T k[Order];
+    T error_gain;
+    T voice_rms;
+};
+
+/*---------------------------------------------------------------------------*\
+|   Floating-point engine with the API and the parameters of TalkBox,         |
+|   samples in [-1, 1].                                                       |
+|                                                                             |
+|   T:        float, or double as a reference                                 |
+|   Order:    number of LPC coefficients                                      |
+|   BlockLen: analysis block length in samples, power of two                  |
+|   NumAcf:   number of block ACFs that are averaged, power of two            |
+|                                                                             |
+|   The member functions are defined in TalkBoxFloat.cpp and instantiated     |
+|   there for the configurations of TalkBox32.h. Voice input, frame handoff   |
+|   and analysis thread are those of TalkBox (talkBoxPipeline.h).             |
+\*---------------------------------------------------------------------------*/
+
+template <class T, int Order, int BlockLen, int NumAcf = 4>
+class TalkBoxFloat : public TalkBoxPipeline<T, LPCFrameFloat<T, Order> >
+{
+public:
+    typedef TalkBoxPipeline<T, LPCFrameFloat<T, Order> > Pipeline;
+
+    static const int num_coeffs = Order;
+    static const int block_length = BlockLen;
+    static const int num_acf = NumAcf;
+    static const int memory_rms_size = 4;
+
+    static_assert((BlockLen & (BlockLen - 1)) == 0, "BlockLen must be a power of two");
+    static_assert((NumAcf & (NumAcf - 1)) == 0, "NumAcf must be a power of two");
+
+protected:
+    using Pipeline::fs;
+    using Pipeline::hop_size;
+    using Pipeline::buffer_position;
+    using Pipeline::sample_buffer;
+    using Pipeline::input_blocks;
+    using Pipeline::lpc_frames;
+    using Pipeline::pushBlock;
+
+    T voice_rms;
+    T error_gain;
+    float smoothing_time;
+    T high_pass_coeff;
+    T memory_hp[2];
+    T memory_rms[memory_rms_size];
+    T acf_alpha;
+    NoiseGate<T> gate;
+    int acf_index;
+    T acf[num_acf][num_coeffs + 1];
+    T window[block_length];
+    T window_buffer[block_length];
+    T analysis_buffer[block_length];
+    T acf_smooth[num_coeffs + 1];
+    T a_temp[num_coeffs];
+    T k_temp[num_coeffs];
+    T a[num_coeffs];
+    T k[num_coeffs];
+    T memory_lpc[2 * num_coeffs];
+    int lpc_position;
+    T memory_lattice[num_coeffs];
+    bool use_lattice;
+    bool use_interpolation;
+    bool filter_silent;             // memory cleared, no voiced frame since
+    const LPCFrameFloat<T, Order> *ramp_frame;
+    int ramp_count;
+    T gain_ramp;
+    T gain_step;
+    T k_ramp[num_coeffs];
+    T k_step[num_coeffs];
+
+    bool analyzeBlock(void) override;
+    void publishFrame(void);
+    void startRamp(const LPCFrameFloat<T, Order> *frame);
+    T synthesize(T carrierSample, const LPCFrameFloat<T, Order> *frame);
+    bool silentBlock(const LPCFrameFloat<T, Order> *frame);
+    void updateSilence(const LPCFrameFloat<T, Order> *frame);
+    void synthesizeBlock(const T *carrier, T *out, int stride, int num_samples,
+                         int position, const LPCFrameFloat<T, Order> *frame);
+
+public:
+    TalkBoxFloat(double fs, int num_blocks = 2);
+    ~TalkBoxFloat(void);
+    void process(T samples[]);
+    void processBlock(T samples[], int num_samples);
+    void processBlock(const T *carrier, const T *voice, T *out, int num_samples);
+    using Pipeline::pushVoice;
+    using Pipeline::getFrame;
+    using Pipeline::calculateLPCcoefficients;
+    using Pipeline::stopAnalysisThread;
+    void resetStates(void);
+    void setSmoothingTime(float tau);
+    void setHopSize(int hop);
+    float getAnalysisLatency(void);
+    void setGateLevel(float level);
+    void setPreemphasis(float fcuttoff);
+    void setLatticeFilter(bool enable);
+    void setInterpolation(bool enable);
+    int  getNumCoeffs(void);
+    void getCoefficients(float all_pole_coefficients[]);
+    void getReflectionCoefficients(float reflection_coefficients[]);
+    float getPreemphasis(void);
+    float getErrorGain(void);
+    float getVoiceGain(void);
+};
+
+typedef TalkBoxFloat<float, 50, 512> TalkBoxF32;    // default configuration
+typedef TalkBoxFloat<double, 50, 512> TalkBoxF64;   // reference
+
+#endif  // _TALK_BOX_FLOAT
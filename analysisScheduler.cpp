@@ -0,0 +1,247 @@
+#include <chrono>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "analysisScheduler.h"
+
+inline double readTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+AnalysisScheduler::AnalysisScheduler(int num_workers, bool pin_workers)
+{
+    if (num_workers <= 0)
+        num_workers = std::thread::hardware_concurrency();
+    if (num_workers <= 0)
+        num_workers = 1;
+
+    this->num_workers = num_workers;
+    this->pin_workers = pin_workers;
+
+    // a quarter of the 64 sample hop at 48 kHz, see setPollInterval()
+    poll_interval = 333;
+    jobs_stolen = 0;
+    running = true;
+
+    workers = new Worker[num_workers];
+
+    for (int i = 0; i < num_workers; i++)
+    {
+        workers[i].thread = std::thread(&AnalysisScheduler::workerLoop, this, i);
+
+#if defined(__linux__)
+        if (pin_workers)
+        {
+            int num_cpus = std::thread::hardware_concurrency();
+            cpu_set_t cpus;
+
+            CPU_ZERO(&cpus);
+            CPU_SET(num_cpus > 0 ? i % num_cpus : 0, &cpus);
+            pthread_setaffinity_np(workers[i].thread.native_handle(), sizeof(cpus), &cpus);
+        }
+#endif
+    }
+}
+
+AnalysisScheduler::~AnalysisScheduler(void)
+{
+    running = false;
+
+    for (int i = 0; i < num_workers; i++)
+        workers[i].thread.join();
+
+    for (int i = 0; i < num_workers; i++)
+        for (Entry *entry : workers[i].entries)
+            delete entry;
+
+    delete[] workers;
+}
+
+void AnalysisScheduler::addTask(AnalysisTask *task)
+{
+    std::lock_guard<std::mutex> registry(registry_lock);
+
+    Entry *entry = new Entry;
+    entry->task = task;
+    entry->busy = false;
+    entry->removed = false;
+
+    // to the worker with the fewest tasks
+    int index = 0;
+    for (int i = 1; i < num_workers; i++)
+        if (workers[i].entries.size() < workers[index].entries.size())
+            index = i;
+
+    std::lock_guard<std::mutex> worker(workers[index].lock);
+    workers[index].entries.push_back(entry);
+}
+
+void AnalysisScheduler::removeTask(AnalysisTask *task)
+{
+    Entry *entry = 0;
+
+    {
+        std::lock_guard<std::mutex> registry(registry_lock);
+
+        for (int i = 0; i < num_workers && entry == 0; i++)
+        {
+            std::lock_guard<std::mutex> worker(workers[i].lock);
+            std::vector<Entry *> &entries = workers[i].entries;
+
+            for (size_t j = 0; j < entries.size(); j++)
+            {
+                if (entries[j]->task == task)
+                {
+                    entry = entries[j];
+                    entries.erase(entries.begin() + j);
+                    break;
+                }
+            }
+        }
+    }
+
+    if (entry == 0)
+        return;
+
+    // a queued job of the task is dropped, a running one finishes
+    entry->removed = true;
+    while (entry->busy.load(std::memory_order_acquire))
+        std::this_thread::sleep_for(std::chrono::microseconds(poll_interval));
+
+    delete entry;
+}
+
+void AnalysisScheduler::setPollInterval(double seconds)
+{
+    // how often an idle worker looks for ready blocks, should be well below
+    // the shortest hop of the tasks (hop_size / fs)
+    poll_interval = (long) (seconds * 1e6);
+}
+
+int AnalysisScheduler::getNumWorkers(void)
+{
+    return num_workers;
+}
+
+uint64_t AnalysisScheduler::getStolenJobs(void)
+{
+    return jobs_stolen.load(std::memory_order_relaxed);
+}
+
+void AnalysisScheduler::pollTasks(int index)
+{
+    Worker &worker = workers[index];
+    std::lock_guard<std::mutex> lock(worker.lock);
+    double now = readTime();
+
+    for (Entry *entry : worker.entries)
+    {
+        if (entry->busy.load(std::memory_order_acquire) || entry->task->getReadyBlocks() == 0)
+            continue;
+
+        entry->busy.store(true, std::memory_order_relaxed);
+
+        // insert by deadline, the deque is short
+        Job job = { entry, now + entry->task->getSlack() };
+        auto position = worker.jobs.end();
+        while (position != worker.jobs.begin() && (position - 1)->deadline > job.deadline)
+            position--;
+
+        worker.jobs.insert(position, job);
+    }
+}
+
+bool AnalysisScheduler::popJob(int index, Job &job)
+{
+    Worker &worker = workers[index];
+    std::lock_guard<std::mutex> lock(worker.lock);
+
+    if (worker.jobs.empty())
+        return false;
+
+    job = worker.jobs.front();
+    worker.jobs.pop_front();
+    return true;
+}
+
+bool AnalysisScheduler::stealJob(int index, Job &job)
+{
+    // the latest deadline of the next worker that has jobs,
+    // the owner keeps the urgent ones at the front
+    for (int i = 1; i < num_workers; i++)
+    {
+        Worker &victim = workers[(index + i) % num_workers];
+        std::lock_guard<std::mutex> lock(victim.lock);
+
+        if (victim.jobs.empty())
+            continue;
+
+        job = victim.jobs.back();
+        victim.jobs.pop_back();
+        jobs_stolen.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    return false;
+}
+
+void AnalysisScheduler::workerLoop(int index)
+{
+    Job job;
+
+    while (running)
+    {
+        bool found = false;
+
+        pollTasks(index);
+
+        while (running && (popJob(index, job) || stealJob(index, job)))
+        {
+            // one block per job, a task with more ready blocks is queued
+            // again with its new deadline by the next poll
+            if (!job.entry->removed.load(std::memory_order_relaxed))
+                job.entry->task->analyzeNextBlock();
+
+            job.entry->busy.store(false, std::memory_order_release);
+            found = true;
+        }
+
+        if (!found)
+            std::this_thread::sleep_for(std::chrono::microseconds(poll_interval));
+    }
+
+    // release the jobs left in the deque
+    std::lock_guard<std::mutex> lock(workers[index].lock);
+    for (Job &left : workers[index].jobs)
+        left.entry->busy.store(false, std::memory_order_release);
+    workers[index].jobs.clear();
+}
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,76 @@
+#ifndef _ANALYSIS_SCHEDULER
+#define _ANALYSIS_SCHEDULER
+
+#include <stdint.h>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "analysisTask.h"
+
+/*---------------------------------------------------------------------------*\
+|   Pool of analysis worker threads for many TalkBox instances                |
+|                                                                             |
+|   Every registered task belongs to one worker, which polls its tasks for    |
+|   ready blocks (the audio threads are never signalled) and queues them in   |
+|   its deque, ordered by deadline. A worker runs the earliest deadline of    |
+|   its own deque first and steals the latest one of another worker when its  |
+|   deque is empty. A task is queued or running on at most one worker at a    |
+|   time, so its analysis stays single-consumer.                              |
+|                                                                             |
+|   The workers are pinned to cores 0, 1, ... on Linux. Tasks have to be      |
+|   removed before they are destroyed; removeTask() waits for a running       |
+|   analysis of the task and must not be called from a task.                  |
+\*---------------------------------------------------------------------------*/
+
+class AnalysisScheduler
+{
+protected:
+    struct Entry
+    {
+        AnalysisTask *task;
+        std::atomic<bool> busy;         // queued or running
+        std::atomic<bool> removed;
+    };
+
+    struct Job
+    {
+        Entry *entry;
+        double deadline;                // s, steady clock
+    };
+
+    struct Worker
+    {
+        std::mutex lock;                // entries and jobs
+        std::vector<Entry *> entries;
+        std::deque<Job> jobs;           // ascending deadline
+        std::thread thread;
+    };
+
+    int num_workers;
+    bool pin_workers;
+    Worker *workers;
+    std::mutex registry_lock;           // addTask/removeTask
+    std::atomic<bool> running;
+    std::atomic<long> poll_interval;    // us
+    std::atomic<uint64_t> jobs_stolen;
+
+    void workerLoop(int index);
+    void pollTasks(int index);
+    bool popJob(int index, Job &job);
+    bool stealJob(int index, Job &job);
+
+public:
+    // num_workers = 0: one per hardware thread
+    AnalysisScheduler(int num_workers = 0, bool pin_workers = true);
+    ~AnalysisScheduler(void);
+    void addTask(AnalysisTask *task);
+    void removeTask(AnalysisTask *task);
+    void setPollInterval(double seconds);
+    int  getNumWorkers(void);
+    uint64_t getStolenJobs(void);
+};
+
+#endif  // _ANALYSIS_SCHEDULER
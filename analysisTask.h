@@ -0,0 +1,22 @@
+#ifndef _ANALYSIS_TASK
+#define _ANALYSIS_TASK
+
+// interface between an analysis (TalkBox) and the AnalysisScheduler,
+// all functions are called from the consumer side of the block ring
+class AnalysisTask
+{
+public:
+    virtual ~AnalysisTask(void) {}
+
+    // analyzes the oldest complete block, false if there is none
+    virtual bool analyzeNextBlock(void) = 0;
+
+    // complete blocks waiting for the analysis
+    virtual int getReadyBlocks(void) = 0;
+
+    // seconds until the ring is full and the next block boundary
+    // overwrites a block, the deadline of the oldest ready block
+    virtual double getSlack(void) = 0;
+};
+
+#endif  // _ANALYSIS_TASK
@@ -0,0 +1,796 @@
+/*---------------------------------------------------------------------------*\
+|   Benchmark of the fixed-point kernels and the TalkBox32 pipeline           |
+|                                                                             |
+|   g++ -std=c++17 -O2 -march=native -o benchTalkBox32 benchTalkBox32.cpp     |
+|       TalkBox32.cpp TalkBoxBank32.cpp TalkBoxFloat.cpp calcAutoCoeff32.cpp  |
+|       fftAutoCoeff32.cpp durbin32.cpp schur32.cpp lpcFilter32.cpp           |
+|       analysisScheduler.cpp -lpthread                                       |
+|                                                                             |
+|   benchTalkBox32 [--json] [--fs 48000]                                      |
+|                                                                             |
+|   ns/sample and cycles/sample are the cost per input sample, per-block      |
+|   kernels are divided by the block length. rtf is the real-time factor      |
+|   at fs, i.e. processing time / signal duration (< 1 is faster).            |
+|   Cycles are the ticks of readCycles() in cycleCounter.h.                   |
+\*---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "TalkBox32.h"
+#include "TalkBoxBank32.h"
+#include "TalkBoxFloat.h"
+#include "analysisScheduler.h"
+#include "cycleCounter.h"
+#include "calcAutoCoeff32.h"
+#include "slidingAutoCoeff32.h"
+#include "durbin32.h"
+#include "schur32.h"
+#include "calcAutoCoeff16.h"
+#include "lpcFilter32.h"
+#include "latticeFilter32.h"
+#include "log32.h"
+
+const int bench_orders[] = { 8, 16, 32, 64, 128 };
+const int bench_lengths[] = { 64, 128, 256, 512, 1024, 2048 };
+const int bench_signal_length = 1 << 16;
+const double bench_min_time = 0.02;     // s per measurement
+const int bench_repetitions = 5;        // best of
+
+static double fs = 48000;
+static bool json = false;
+static int num_results = 0;
+static volatile int32_t sink;
+static volatile float sink_float;
+
+inline double readTime(void)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// synthetic voice (harmonics with vibrato, noise and pauses) and carrier (sawtooth)
+static void makeSignals(int32_t *carrier, int32_t *voice, int n)
+{
+    uint32_t seed = 12345;
+    double phase_carrier = 0;
+    double phase_voice = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double noise = ((int32_t) seed) / 2147483648.0;
+
+        phase_carrier += 110.0 / fs;
+        if (phase_carrier >= 1)
+            phase_carrier -= 1;
+
+        phase_voice += 180.0 / fs * (1 + 0.03 * sin(2 * M_PI * 5 * i / fs));
+        if (phase_voice >= 1)
+            phase_voice -= 1;
+
+        double envelope = ((i / (int) (fs * 0.5)) % 3 == 2) ? 0.0 : 1.0;
+        double v = sin(2 * M_PI * phase_voice) + 0.5 * sin(4 * M_PI * phase_voice + 0.3)
+                 + 0.25 * sin(6 * M_PI * phase_voice) + 0.05 * noise;
+
+        carrier[i] = (int32_t) ((2 * phase_carrier - 1) * 0.5 * 0x7FFFFFFF);
+        voice[i] = (int32_t) (v * 0.3 * envelope * 0x7FFFFFFF);
+    }
+}
+
+static void report(const char *name, int order, int length, double seconds, double cycles, double samples)
+{
+    double ns_per_sample = 1e9 * seconds / samples;
+    double cycles_per_sample = cycles / samples;
+    double rtf = seconds * fs / samples;
+
+    if (json)
+    {
+        printf("%s\n    {\"name\": \"%s\", \"order\": %d, \"length\": %d, "
+               "\"ns_per_sample\": %.4f, \"cycles_per_sample\": %.3f, \"rtf\": %.3e}",
+               num_results ? "," : "", name, order, length, ns_per_sample, cycles_per_sample, rtf);
+    }
+    else
+    {
+        printf("%-34s %6d %6d %12.3f %12.2f %12.3e\n",
+               name, order, length, ns_per_sample, cycles_per_sample, rtf);
+    }
+    num_results++;
+}
+
+// runs body(iterations) until it takes bench_min_time, best time of bench_repetitions
+template <class Body>
+static void measure(const char *name, int order, int length, double samples_per_iteration, Body body)
+{
+    long iterations = 1;
+    double seconds, best_seconds = 1e30, best_cycles = 0;
+
+    // calibration
+    for (;;)
+    {
+        double t0 = readTime();
+        body(iterations);
+        seconds = readTime() - t0;
+        if (seconds >= bench_min_time)
+            break;
+        iterations *= (seconds > bench_min_time / 16) ? 2 : 16;
+    }
+
+    for (int r = 0; r < bench_repetitions; r++)
+    {
+        double t0 = readTime();
+        uint64_t c0 = readCycles();
+        body(iterations);
+        uint64_t c1 = readCycles();
+        seconds = readTime() - t0;
+
+        if (seconds < best_seconds)
+        {
+            best_seconds = seconds;
+            best_cycles = (double) (c1 - c0);
+        }
+    }
+
+    report(name, order, length, best_seconds, best_cycles, samples_per_iteration * iterations);
+}
+
+static void benchFilters(const int32_t *carrier)
+{
+    const int n = 4096;
+    int32_t a[128], k[128], r[129];
+    int32_t memory[2 * 128];
+    int64_t memory_lattice[128];
+    int32_t memory_narrow[128];
+    int32_t signal[n];
+
+    // stable coefficients of a smooth spectrum
+    for (int i = 0; i <= 128; i++)
+        r[i] = (int32_t) (0x7FFFFFFF * exp(-0.02 * i * i / 128.) * cos(0.3 * i));
+
+    for (int order : bench_orders)
+    {
+        durbin32(r, a, order, fractional_digits, (int32_t) (0.999 * 0x7FFFFFFF), k);
+
+        for (int i = 0; i < n; i++)
+            signal[i] = carrier[i] >> 6;
+
+        memset(memory, 0, sizeof(memory));
+        measure("lpcFilter32", order, 0, n, [&](long iterations)
+        {
+            int32_t sum = 0;
+            for (long it = 0; it < iterations; it++)
+                for (int i = 0; i < n; i++)
+                    sum += lpcFilter32(signal[i], a, memory, order, fractional_digits);
+            sink = sum;
+        });
+
+        memset(memory, 0, sizeof(memory));
+        int position = 0;
+        measure("lpcFilterCircular32", order, 0, n, [&](long iterations)
+        {
+            int32_t sum = 0;
+            for (long it = 0; it < iterations; it++)
+                for (int i = 0; i < n; i++)
+                    sum += lpcFilterCircular32(signal[i], a, memory, &position, order, fractional_digits);
+            sink = sum;
+        });
+
+        memset(memory_lattice, 0, sizeof(memory_lattice));
+        measure("latticeFilter32", order, 0, n, [&](long iterations)
+        {
+            int32_t sum = 0;
+            for (long it = 0; it < iterations; it++)
+                for (int i = 0; i < n; i++)
+                    sum += latticeFilter32(signal[i], k, memory_lattice, order, fractional_digits);
+            sink = sum;
+        });
+
+        memset(memory_narrow, 0, sizeof(memory_narrow));
+        measure("latticeFilter32 narrow", order, 0, n, [&](long iterations)
+        {
+            int32_t sum = 0;
+            for (long it = 0; it < iterations; it++)
+                for (int i = 0; i < n; i++)
+                    sum += latticeFilter32(signal[i], k, memory_narrow, order, fractional_digits);
+            sink = sum;
+        });
+    }
+}
+
+static void benchAnalysis(const int32_t *voice)
+{
+    int32_t acf[129], a[128];
+    std::vector<int32_t> block(2048);
+    std::vector<int16_t> block16(2048);
+
+    for (int order : bench_orders)
+    {
+        for (int length : bench_lengths)
+        {
+            // calcAutoCoeff32 normalizes the block in place, the first call
+            // leaves a block that is shifted by zero bits afterwards
+            memcpy(block.data(), &voice[4096], length * sizeof(int32_t));
+
+            measure("calcAutoCoeff32 direct", order, length, length, [&](long iterations)
+            {
+                for (long it = 0; it < iterations; it++)
+                    calcAutoCoeff32(acf, order + 1, block.data(), length, false);
+                sink = acf[1];
+            });
+
+            if (length <= fft_acf_max_length)
+            {
+                memcpy(block.data(), &voice[4096], length * sizeof(int32_t));
+
+                measure("calcAutoCoeff32 fft", order, length, length, [&](long iterations)
+                {
+                    for (long it = 0; it < iterations; it++)
+                        calcAutoCoeff32(acf, order + 1, block.data(), length, true);
+                    sink = acf[1];
+                });
+            }
+
+            memcpy(block.data(), &voice[4096], length * sizeof(int32_t));
+            int32_t max_value = maxAbs32(block.data(), length);
+
+            measure("calcAutoCoeff16", order, length, length, [&](long iterations)
+            {
+                for (long it = 0; it < iterations; it++)
+                    calcAutoCoeff16(acf, order + 1, block.data(), block16.data(), length, max_value);
+                sink = acf[1];
+            });
+        }
+
+        // the durbin recursion runs once per block
+        memcpy(block.data(), &voice[4096], 2048 * sizeof(int32_t));
+        calcAutoCoeff32(acf, order + 1, block.data(), 2048, false);
+
+        for (int length : bench_lengths)
+        {
+            measure("durbin32", order, length, length, [&](long iterations)
+            {
+                for (long it = 0; it < iterations; it++)
+                    durbin32(acf, a, order, fractional_digits, (int32_t) (0.999 * 0x7FFFFFFF));
+                sink = a[0];
+            });
+
+            measure("schur32", order, length, length, [&](long iterations)
+            {
+                for (long it = 0; it < iterations; it++)
+                    schur32(acf, a, order, fractional_digits, (int32_t) (0.999 * 0x7FFFFFFF));
+                sink = a[0];
+            });
+        }
+    }
+}
+
+// incremental ACF, one result per hop of 64 samples, the cost per sample
+// does not depend on the window length
+template <int order, int length>
+static void benchSlidingAcf(const int32_t *voice)
+{
+    const int n = 4096, hop = 64;
+    static SlidingAutoCoeff32<order + 1, length> sliding;
+    int32_t acf[order + 1];
+
+    measure("SlidingAutoCoeff32 hop 64", order, length, n, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += hop)
+            {
+                sliding.push(&voice[i], hop);
+                sliding.get(acf);
+            }
+        sink = acf[1];
+    });
+}
+
+static void benchLogExp(const int32_t *voice)
+{
+    const int n = 4096;
+
+    measure("log32", 0, 0, n, [&](long iterations)
+    {
+        int32_t sum = 0;
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i++)
+                sum += log32(labs(voice[i]) | 1);
+        sink = sum;
+    });
+
+    measure("exp32", 0, 0, n, [&](long iterations)
+    {
+        int32_t sum = 0;
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i++)
+                sum += exp32(-(labs(voice[i]) >> 4));
+        sink = sum;
+    });
+}
+
+// process() per sample with the analysis inline, processBlock() in blocks of
+// 64 samples, and the analysis alone
+template <class TB>
+static void benchPipeline(const char *name, const int32_t *carrier, const int32_t *voice)
+{
+    const int n = bench_signal_length;
+    const int host_block = 64;
+    std::vector<int32_t> out(n);
+    char label[64];
+
+    TB talkbox(fs);
+
+    snprintf(label, sizeof(label), "%s::process", name);
+    measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+    {
+        int32_t s[2];
+        int32_t sum = 0;
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i++)
+            {
+                s[0] = carrier[i];
+                s[1] = voice[i];
+                talkbox.process(s);
+                sum += s[0];
+
+                if ((i & (TB::block_length - 1)) == TB::block_length - 1)
+                    talkbox.calculateLPCcoefficients();
+            }
+        sink = sum;
+    });
+
+    talkbox.resetStates();
+    snprintf(label, sizeof(label), "%s::processBlock", name);
+    measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += host_block)
+            {
+                talkbox.processBlock(&carrier[i], &voice[i], &out[i], host_block);
+                talkbox.calculateLPCcoefficients();
+            }
+        sink = out[n - 1];
+    });
+
+    // the analysis alone, one block at a time
+    talkbox.resetStates();
+    snprintf(label, sizeof(label), "%s::calculateLPC", name);
+    measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += TB::block_length)
+            {
+                talkbox.pushVoice(&voice[i], TB::block_length);
+                talkbox.calculateLPCcoefficients();
+            }
+        sink = talkbox.getFrame()->error_gain;
+    });
+}
+
+// an idle channel, the voice 78 dB down, without and with the gate
+template <class TB>
+static void benchSilence(const char *name, const int32_t *carrier, const int32_t *voice)
+{
+    const int n = bench_signal_length;
+    const int host_block = 64;
+    std::vector<int32_t> quiet(n), out(n);
+    char label[64];
+
+    for (int i = 0; i < n; i++)
+        quiet[i] = voice[i] >> 13;
+
+    TB talkbox(fs);
+
+    for (int gate = 0; gate < 2; gate++)
+    {
+        talkbox.setGateLevel(gate ? 0.001f : 0.f);
+        talkbox.resetStates();
+
+        snprintf(label, sizeof(label), "%s silent, gate %s", name, gate ? "on" : "off");
+        measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+        {
+            for (long it = 0; it < iterations; it++)
+                for (int i = 0; i < n; i += host_block)
+                {
+                    talkbox.processBlock(&carrier[i], &quiet[i], &out[i], host_block);
+                    talkbox.calculateLPCcoefficients();
+                }
+            sink = out[n - 1];
+        });
+    }
+}
+
+// the analysis alone with decimation factors 1, 2 and 4, without and with
+// overlapping blocks, meant for --fs 96000 and up
+template <class TB>
+static void benchDecimation(const char *name, const int32_t *voice)
+{
+    const int n = bench_signal_length;
+    char label[64];
+
+    TB talkbox(fs);
+
+    for (int hop = TB::block_length; hop >= TB::block_length / 4; hop /= 4)
+    {
+        for (int factor = 1; factor <= decimator_max_factor; factor *= 2)
+        {
+            talkbox.setHopSize(hop);
+            talkbox.setDecimation(factor);
+
+            snprintf(label, sizeof(label), "%s dec %d hop %d", name, talkbox.getDecimation(), hop);
+            measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+            {
+                for (long it = 0; it < iterations; it++)
+                    for (int i = 0; i < n; i += hop)
+                    {
+                        talkbox.pushVoice(&voice[i], hop);
+                        talkbox.calculateLPCcoefficients();
+                    }
+                sink = talkbox.getFrame()->error_gain;
+            });
+        }
+    }
+}
+
+// the analysis alone with setQ15Kernels()
+template <class TB>
+static void benchQ15(const char *name, const int32_t *voice)
+{
+    const int n = bench_signal_length;
+    char label[64];
+
+    TB talkbox(fs);
+    talkbox.setQ15Kernels(true);
+
+    snprintf(label, sizeof(label), "%s Q15::calculateLPC", name);
+    measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += TB::block_length)
+            {
+                talkbox.pushVoice(&voice[i], TB::block_length);
+                talkbox.calculateLPCcoefficients();
+            }
+        sink = talkbox.getFrame()->error_gain;
+    });
+}
+
+// processBlock() with the direct form, the lattice and the interpolated
+// lattice synthesis filter, the lattices also with 32-bit states
+template <class TB>
+static void benchSynthesis(const char *name, const int32_t *carrier, const int32_t *voice)
+{
+    const int n = bench_signal_length;
+    const int host_block = 64;
+    const char *modes[] = { "direct", "lattice", "interpolation", "narrow lattice", "narrow interpolation" };
+    std::vector<int32_t> out(n);
+    char label[64];
+
+    TB talkbox(fs);
+
+    for (int mode = 0; mode < 5; mode++)
+    {
+        talkbox.setLatticeFilter(mode == 1 || mode == 3);
+        talkbox.setInterpolation(mode == 2 || mode == 4);
+        talkbox.setNarrowLattice(mode >= 3);
+        talkbox.resetStates();
+
+        snprintf(label, sizeof(label), "%s %s", name, modes[mode]);
+        measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+        {
+            for (long it = 0; it < iterations; it++)
+                for (int i = 0; i < n; i += host_block)
+                {
+                    talkbox.processBlock(&carrier[i], &voice[i], &out[i], host_block);
+                    talkbox.calculateLPCcoefficients();
+                }
+            sink = out[n - 1];
+        });
+    }
+}
+
+// many instances driven by one thread in blocks of 64 samples, from a few
+// hundred on the state of all instances exceeds the caches: the audio side
+// alone, and with the analysis inline. The instances are primed with the
+// voiced part of the signal, so that the audio side filters with the last
+// voiced frame instead of outputting silence; the rows are throughput, not
+// a count of cache misses
+template <class TB>
+static void benchInstances(const char *name, int num_instances, const int32_t *carrier, const int32_t *voice)
+{
+    const int n = 4096;
+    const int host_block = 64;
+    std::vector<TB *> talkboxes(num_instances);
+    int32_t out[host_block];
+    char label[64];
+
+    for (int i = 0; i < num_instances; i++)
+    {
+        talkboxes[i] = new TB(fs);
+
+        for (int j = 0; j < n; j += host_block)
+        {
+            talkboxes[i]->processBlock(&carrier[j], &voice[j], out, host_block);
+            talkboxes[i]->calculateLPCcoefficients();
+        }
+    }
+
+    snprintf(label, sizeof(label), "%s x%d audio", name, num_instances);
+    measure(label, TB::num_coeffs, TB::block_length, (double) n * num_instances, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += host_block)
+                for (TB *talkbox : talkboxes)
+                    talkbox->processBlock(&carrier[i], &voice[i], out, host_block);
+        sink = out[0];
+    });
+
+    snprintf(label, sizeof(label), "%s x%d all", name, num_instances);
+    measure(label, TB::num_coeffs, TB::block_length, (double) n * num_instances, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += host_block)
+                for (TB *talkbox : talkboxes)
+                {
+                    talkbox->processBlock(&carrier[i], &voice[i], out, host_block);
+                    talkbox->calculateLPCcoefficients();
+                }
+        sink = out[0];
+    });
+
+    for (TB *talkbox : talkboxes)
+        delete talkbox;
+}
+
+// the floating-point engine in blocks of 64 samples, and the analysis alone,
+// signals scaled to [-1, 1]
+template <class TB>
+static void benchFloat(const char *name, const int32_t *carrier, const int32_t *voice)
+{
+    typedef float T;
+    const int n = bench_signal_length;
+    const int host_block = 64;
+    std::vector<T> carrier_float(n), voice_float(n), out(n);
+    char label[64];
+
+    for (int i = 0; i < n; i++)
+    {
+        carrier_float[i] = (T) (carrier[i] / 2147483648.);
+        voice_float[i] = (T) (voice[i] / 2147483648.);
+    }
+
+    TB talkbox(fs);
+
+    snprintf(label, sizeof(label), "%s::processBlock", name);
+    measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += host_block)
+            {
+                talkbox.processBlock(&carrier_float[i], &voice_float[i], &out[i], host_block);
+                talkbox.calculateLPCcoefficients();
+            }
+        sink_float = out[n - 1];
+    });
+
+    talkbox.resetStates();
+    snprintf(label, sizeof(label), "%s::calculateLPC", name);
+    measure(label, TB::num_coeffs, TB::block_length, n, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += TB::block_length)
+            {
+                talkbox.pushVoice(&voice_float[i], TB::block_length);
+                talkbox.calculateLPCcoefficients();
+            }
+        sink_float = talkbox.getFrame()->error_gain;
+    });
+}
+
+// num_voices voices of a TalkBoxBank in blocks of 64 samples, signals
+// interleaved by voice, each voice offset in time; primed and to be compared
+// as benchInstances of the same number of TalkBox instances
+template <class TB>
+static void benchBank(const char *name, int num_voices, const int32_t *carrier, const int32_t *voice)
+{
+    const int n = 4096;
+    const int host_block = 64;
+    std::vector<int32_t> carrier_bank(n * num_voices), voice_bank(n * num_voices), out(host_block * num_voices);
+    char label[64];
+
+    for (int i = 0; i < n; i++)
+        for (int v = 0; v < num_voices; v++)
+        {
+            carrier_bank[i * num_voices + v] = carrier[(i + v * n) % bench_signal_length];
+            voice_bank[i * num_voices + v] = voice[(i + v * n) % bench_signal_length];
+        }
+
+    TB bank(fs, num_voices);
+
+    for (int i = 0; i < n; i += host_block)
+    {
+        bank.processBlock(&carrier_bank[i * num_voices], &voice_bank[i * num_voices], out.data(), host_block);
+        bank.calculateLPCcoefficients();
+    }
+
+    snprintf(label, sizeof(label), "%s x%d audio", name, num_voices);
+    measure(label, TB::Voice::num_coeffs, TB::Voice::block_length, (double) n * num_voices, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += host_block)
+                bank.processBlock(&carrier_bank[i * num_voices], &voice_bank[i * num_voices], out.data(), host_block);
+        sink = out[0];
+    });
+
+    snprintf(label, sizeof(label), "%s x%d all", name, num_voices);
+    measure(label, TB::Voice::num_coeffs, TB::Voice::block_length, (double) n * num_voices, [&](long iterations)
+    {
+        for (long it = 0; it < iterations; it++)
+            for (int i = 0; i < n; i += host_block)
+            {
+                bank.processBlock(&carrier_bank[i * num_voices], &voice_bank[i * num_voices], out.data(), host_block);
+                bank.calculateLPCcoefficients();
+            }
+        sink = out[0];
+    });
+}
+
+// analysis throughput of the AnalysisScheduler for 1, 2, 4, ... workers:
+// four TalkBox32 instances (hop 64) per worker start with full rings,
+// the time until all blocks are analyzed is measured
+static void benchScheduler(const int32_t *voice)
+{
+    const int hop = 64;
+    const int instances_per_worker = 4;
+    const int num_blocks = 8;
+    const int ring_blocks = num_blocks * (TalkBox32::block_length / hop) - 1;   // complete blocks
+    int max_workers = std::thread::hardware_concurrency();
+    char label[64];
+
+    if (max_workers < 1)
+        max_workers = 1;
+
+    for (int num_workers = 1; ; num_workers *= 2)
+    {
+        if (num_workers > max_workers)
+            num_workers = max_workers;
+
+        int num_instances = instances_per_worker * num_workers;
+        std::vector<TalkBox32 *> talkboxes(num_instances);
+        AnalysisScheduler scheduler(num_workers);
+        double best_seconds = 1e30, best_cycles = 0;
+        long samples = 0;
+
+        for (int i = 0; i < num_instances; i++)
+        {
+            talkboxes[i] = new TalkBox32(fs, num_blocks);
+            talkboxes[i]->setHopSize(hop);
+        }
+
+        for (int r = 0; r < bench_repetitions; r++)
+        {
+            for (TalkBox32 *talkbox : talkboxes)
+                talkbox->pushVoice(&voice[4096], ring_blocks * hop);
+            samples = (long) num_instances * ring_blocks * hop;
+
+            double t0 = readTime();
+            uint64_t c0 = readCycles();
+
+            for (TalkBox32 *talkbox : talkboxes)
+                scheduler.addTask(talkbox);
+
+            for (TalkBox32 *talkbox : talkboxes)
+                while (talkbox->getReadyBlocks() > 0)
+                    std::this_thread::yield();
+
+            uint64_t c1 = readCycles();
+            double seconds = readTime() - t0;
+
+            for (TalkBox32 *talkbox : talkboxes)
+                scheduler.removeTask(talkbox);
+
+            if (seconds < best_seconds)
+            {
+                best_seconds = seconds;
+                best_cycles = (double) (c1 - c0);
+            }
+        }
+
+        snprintf(label, sizeof(label), "AnalysisScheduler %d workers", num_workers);
+        report(label, TalkBox32::num_coeffs, TalkBox32::block_length, best_seconds, best_cycles, samples);
+
+        for (TalkBox32 *talkbox : talkboxes)
+            delete talkbox;
+
+        if (num_workers == max_workers)
+            break;
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--json") == 0)
+            json = true;
+        else if (strcmp(argv[i], "--fs") == 0 && i + 1 < argc)
+            fs = atof(argv[++i]);
+        else
+        {
+            fprintf(stderr, "usage: %s [--json] [--fs sample_rate]\n", argv[0]);
+            return 1;
+        }
+    }
+
+    std::vector<int32_t> carrier(bench_signal_length), voice(bench_signal_length);
+    makeSignals(carrier.data(), voice.data(), bench_signal_length);
+
+    if (json)
+        printf("{\n  \"fs\": %.0f,\n  \"results\": [", fs);
+    else
+        printf("%-34s %6s %6s %12s %12s %12s\n", "kernel", "order", "length", "ns/sample", "cycles/smp", "rtf");
+
+    benchFilters(carrier.data());
+    benchAnalysis(voice.data());
+    benchSlidingAcf<16, 512>(voice.data());
+    benchSlidingAcf<32, 512>(voice.data());
+    benchSlidingAcf<64, 512>(voice.data());
+    benchSlidingAcf<64, 2048>(voice.data());
+    benchSlidingAcf<128, 2048>(voice.data());
+    benchLogExp(voice.data());
+
+    benchPipeline<TalkBox32>("TalkBox32", carrier.data(), voice.data());
+    benchPipeline<TalkBox32LowLatency>("TalkBox32LowLatency", carrier.data(), voice.data());
+    benchPipeline<TalkBox32HighOrder>("TalkBox32HighOrder", carrier.data(), voice.data());
+    benchQ15<TalkBox32>("TalkBox32", voice.data());
+    benchQ15<TalkBox32LowLatency>("TalkBox32LowLatency", voice.data());
+    benchQ15<TalkBox32HighOrder>("TalkBox32HighOrder", voice.data());
+    benchSynthesis<TalkBox32>("TalkBox32", carrier.data(), voice.data());
+    benchSilence<TalkBox32>("TalkBox32", carrier.data(), voice.data());
+    benchDecimation<TalkBox32>("TalkBox32", voice.data());
+    benchDecimation<TalkBox32HighOrder>("TalkBox32HighOrder", voice.data());
+    benchInstances<TalkBox32>("TalkBox32", 256, carrier.data(), voice.data());
+    benchInstances<TalkBox32LowLatency>("TalkBox32LowLatency", 1024, carrier.data(), voice.data());
+    for (int num_voices : { 4, 8, 64 })
+    {
+        benchInstances<TalkBox32>("TalkBox32", num_voices, carrier.data(), voice.data());
+        benchBank<TalkBoxBank32>("TalkBoxBank32", num_voices, carrier.data(), voice.data());
+    }
+    benchFloat<TalkBoxF32>("TalkBoxF32", carrier.data(), voice.data());
+    benchScheduler(voice.data());
+
+    if (json)
+        printf("\n  ]\n}\n");
+
+    return 0;
+}
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
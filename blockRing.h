@@ -0,0 +1,125 @@
+#ifndef _BLOCK_RING
+#define _BLOCK_RING
+
+#include <atomic>
+#include <new>
+
+#include "cacheLine.h"
+
+/*---------------------------------------------------------------------------*\
+|   Lock-Free Single-Producer/Single-Consumer Ring of Sample Blocks           |
+|                                                                             |
+|   The producer fills writeBlock() and calls push() when the block is        |
+|   complete, the consumer processes readBlock() and releases it with pop().  |
+|   The block being filled always belongs to the producer, so a ring of       |
+|   num_blocks can hold num_blocks - 1 complete blocks. If push() finds the   |
+|   ring full, the write block is not handed over and gets overwritten.       |
+\*---------------------------------------------------------------------------*/
+
+template <class T>
+class BlockRing
+{
+protected:
+    T *buffer;
+    int block_size;
+    int num_blocks;
+    alignas(cache_line_size) std::atomic<int> head;     // block being written, producer
+    alignas(cache_line_size) std::atomic<int> tail;     // oldest complete block, consumer
+
+    void release(void)
+    {
+        if (buffer)
+            ::operator delete[](buffer, std::align_val_t(cache_line_size));
+        buffer = 0;
+    }
+
+public:
+    BlockRing(void) : buffer(0), block_size(0), num_blocks(0), head(0), tail(0) {}
+
+    ~BlockRing(void)
+    {
+        release();
+    }
+
+    // not thread safe, for initialization only
+    void resize(int num_blocks, int block_size)
+    {
+        if (num_blocks < 2)
+            num_blocks = 2;
+
+        // the blocks start at a cache line, T is a sample type
+        release();
+        buffer = (T *) ::operator new[](num_blocks * block_size * sizeof(T), std::align_val_t(cache_line_size));
+
+        this->num_blocks = num_blocks;
+        this->block_size = block_size;
+
+        reset();
+    }
+
+    // not thread safe, for initialization only
+    void reset(void)
+    {
+        for (int i = 0; i < num_blocks * block_size; i++)
+            buffer[i] = 0;
+
+        head.store(0, std::memory_order_relaxed);
+        tail.store(0, std::memory_order_relaxed);
+    }
+
+    int getNumBlocks(void)
+    {
+        return num_blocks;
+    }
+
+    // producer side
+    T *writeBlock(void)
+    {
+        return &buffer[head.load(std::memory_order_relaxed) * block_size];
+    }
+
+    bool push(void)
+    {
+        int next = head.load(std::memory_order_relaxed) + 1;
+        if (next >= num_blocks)
+            next = 0;
+
+        if (next == tail.load(std::memory_order_acquire))
+            return false;
+
+        head.store(next, std::memory_order_release);
+        return true;
+    }
+
+    // consumer side, returns 0 if no complete block is available
+    T *readBlock(void)
+    {
+        int index = tail.load(std::memory_order_relaxed);
+
+        if (index == head.load(std::memory_order_acquire))
+            return 0;
+
+        return &buffer[index * block_size];
+    }
+
+    // complete blocks, exact on the consumer side
+    int getNumComplete(void)
+    {
+        int count = head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed);
+        if (count < 0)
+            count += num_blocks;
+
+        return count;
+    }
+
+    void pop(void)
+    {
+        int next = tail.load(std::memory_order_relaxed) + 1;
+        if (next >= num_blocks)
+            next = 0;
+
+        tail.store(next, std::memory_order_release);
+    }
+};
+
+#endif  // _BLOCK_RING
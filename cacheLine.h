@@ -0,0 +1,8 @@
+#ifndef _CACHE_LINE
+#define _CACHE_LINE
+
+// cache line size of x86-64 and of most ARM cores, data written by different
+// threads is kept in separate lines to avoid false sharing
+const int cache_line_size = 64;
+
+#endif  // _CACHE_LINE
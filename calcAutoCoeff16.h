@@ -0,0 +1,62 @@
+#ifndef _ACF16
+#define _ACF16
+
+#include <stdint.h>
+
+#include "log32.h"
+#include "simd16.h"
+
+const int acf16_max_lags = 256;
+
+// normalized autocorrelation as calcAutoCoeff32 from a 16-bit copy of the
+// signal (block floating point: |temp16| < 2^14 after the shift by the
+// leading sign bits of max_value), num_acf <= acf16_max_lags, temp16 has
+// num_signal samples
+inline void calcAutoCoeff16(int32_t *acf, int num_acf, const int32_t *signal, int16_t *temp16,
+                            int num_signal, int32_t max_value)
+{
+    int64_t sum[acf16_max_lags] = { 0 };
+    int64_t temp64;
+    int k, n_shift;
+
+    if (max_value == 0)
+    {
+        acf[0] = 0x7FFFFFFF;
+        for (k = 1; k < num_acf; k++)
+            acf[k] = 0;
+        return;
+    }
+
+    // max_value < 2^(31 - nlzs), shifted below 2^14
+    n_shift = 17 - nlzs(max_value);
+    shiftTo16(signal, temp16, num_signal, n_shift);
+
+    autoCorrelation16(sum, num_acf, temp16, num_signal);
+
+    // sum[0] to 2^30 <= acf[0] < 2^31, |sum[k]| <= sum[0]
+    n_shift = 0;
+    for (temp64 = sum[0]; temp64 >= (1LL << 31); temp64 >>= 1)
+        n_shift++;
+    for (; temp64 < (1LL << 30); temp64 <<= 1)
+        n_shift--;
+
+    for (k = 0; k < num_acf; k++)
+        acf[k] = (int32_t) ((n_shift > 0) ? sum[k] >> n_shift : sum[k] << -n_shift);
+
+    // 1/acf[0] in 4.28 format, acf[k] / acf[0] in 1.31 format
+    int32_t inv_acf0 = (int32_t) ((1LL << 59) / acf[0]);
+
+    const int64_t max_acf = (1ll << 59)-1;
+
+    for (k = 0; k < num_acf; k++)
+    {
+        temp64 = ((int64_t) acf[k] * inv_acf0);
+
+        if (temp64 > max_acf)
+            temp64 = max_acf;
+
+        acf[k] = (int32_t) (temp64 >> 28);
+    }
+}
+
+#endif  // _ACF16
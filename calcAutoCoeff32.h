@@ -3,6 +3,105 @@
 
 #include <stdint.h>
 
+#include "fftAutoCoeff32.h"
+#include "simd32.h"
+
+// normalized autocorrelation, FFT based from fft_acf_min_lags lags on
 void calcAutoCoeff32(int32_t *acf, int num_acf,int32_t *signal, int num_signal);
 
+// with explicit choice of the direct or the FFT method, max_value is
+// max(abs(signal)) as computed by maxAbs32, e.g. by the caller's pre-pass
+inline void calcAutoCoeff32(int32_t *acf, int num_acf, int32_t *signal, int num_signal, bool use_fft,
+                            int32_t max_value)
+{
+    int i, k, n_shift;
+    int64_t temp64;
+    int32_t temp32;
+
+    // integer base 2 logarithm
+    n_shift = 0;
+    for (i = 1; i < num_signal; i *= 2)
+        n_shift++;
+    n_shift = (n_shift + 1) / 2;
+
+    // number of leading signals of signal
+    for (i = 0; i < 32; i++)
+    {
+        if (max_value >= 0x40000000)
+            break;
+
+        max_value = max_value << 1;
+        n_shift--;
+    }
+
+    // normalization of signal and acf[0] in one pass
+    temp64 = shiftEnergy32(signal, num_signal, n_shift);
+    temp32 = (int32_t) (temp64 >> 32);
+
+    if (temp32 == 0)
+    {
+        acf[0] = 0x7FFFFFFF;
+        for (k = 1; k <num_acf; k++)
+            acf[k] = 0;
+        return;
+    }
+
+    // number of leading zeros of acf[0]
+    for (i = 0; i < 32; i++)
+    {
+        if (temp32 >= 0x20000000)
+            break;
+
+        temp32 = temp32 << 1;
+    }
+
+    // 32 - nlz(acf[0])
+    n_shift = 32 - i;
+
+    // autocorrelation function, FFT based for high orders and long blocks;
+    // acf[0] keeps the exact energy (temp64) so that the normalization is unchanged
+    if (use_fft && fftAutoCoeff32(acf, num_acf, signal, num_signal, n_shift))
+    {
+        acf[0] = (int32_t) (temp64 >> n_shift);
+    }
+    else
+    {
+        autoCorrelation32(acf, num_acf, signal, num_signal, n_shift);
+    }
+
+    // 1/acf[0] in 4.28 format, 5.59 / 1.31 = 4.28
+    int32_t inv_acf0 = (int32_t) ((1LL << 59) / acf[0]);
+
+    const int64_t max_acf = (1ll << 59)-1;
+
+    // acf[i] = acf[i] / acf[0];
+    for (k = 0; k < num_acf; k++)
+    {
+        temp64 = ((int64_t) acf[k] * inv_acf0);
+
+        if (temp64 > max_acf)
+            temp64 = max_acf;
+
+        acf[k] = (int32_t) (temp64 >> 28);
+    }
+}
+
+inline void calcAutoCoeff32(int32_t *acf, int num_acf, int32_t *signal, int num_signal, bool use_fft)
+{
+    calcAutoCoeff32(acf, num_acf, signal, num_signal, use_fft, maxAbs32(signal, num_signal));
+}
+
+// block length and number of lags fixed at compile time
+template <int num_acf, int num_signal>
+inline void calcAutoCoeff32(int32_t *acf, int32_t *signal)
+{
+    calcAutoCoeff32(acf, num_acf, signal, num_signal, num_acf >= fft_acf_min_lags);
+}
+
+template <int num_acf, int num_signal>
+inline void calcAutoCoeff32(int32_t *acf, int32_t *signal, int32_t max_value)
+{
+    calcAutoCoeff32(acf, num_acf, signal, num_signal, num_acf >= fft_acf_min_lags, max_value);
+}
+
 #endif  // _ACF32
@@ -0,0 +1,860 @@
+/*---------------------------------------------------------------------------*\
+|   Accuracy checks of the fixed-point kernels                                |
+|                                                                             |
+|   g++ -std=c++17 -O2 -march=native -o checkTalkBox32 checkTalkBox32.cpp     |
+|       TalkBox32.cpp TalkBoxFloat.cpp calcAutoCoeff32.cpp fftAutoCoeff32.cpp |
+|       durbin32.cpp schur32.cpp lpcFilter32.cpp -lpthread                    |
+|                                                                             |
+|   checkTalkBox32                                                            |
+|                                                                             |
+|   Every check compares a kernel with a double precision reference, or an    |
+|   approximation with the exact kernel (fftAutoCoeff32 with the direct sum,  |
+|   order is the number of lags there), and prints the measured error next to |
+|   its limit. The API checks count the samples in which two paths that must  |
+|   be bit-exact differ. The exit code is the number of failed checks, so the |
+|   program can run after every build (also without -march=native, which      |
+|   selects the scalar kernels).                                              |
+\*---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stdint.h>
+#include <vector>
+
+#include "TalkBox32.h"
+#include "TalkBoxFloat.h"
+#include "calcAutoCoeff32.h"
+#include "durbin32.h"
+#include "latticeFilter32.h"
+#include "lpcFilter32.h"
+#include "schur32.h"
+#include "simd32.h"
+#include "slidingAutoCoeff32.h"
+
+const int check_orders[] = { 8, 24, 50, 100, 128 };
+const int32_t k_max = (int32_t) (0.999 * 0x7FFFFFFF);
+const double check_levels[] = { 0.02, 1e-3, 4e-5 };     // rms of the input, re full scale
+const int check_signal_length = 1 << 15;
+const double lattice_min_snr = 100;                     // dB
+const double narrow_lattice_min_snr = 110;              // dB at 0.02, 6 dB less per bit of level
+const int check_hops[] = { 512, 128, 32 };
+const int acf_lengths[] = { 64, 256, 512, 2048 };
+const int acf_lags[] = { 9, 51, 101, 257 };
+const double acf_max_error = -16;                       // log2 of |error| / acf[0]
+const char *acf_signal_names[] = { "noise", "tonal", "silent", "full" };
+const double acf_signal_levels[] = { 0.3, 0.5, 0, 1 };
+const double sliding_acf_max_error = -24;               // log2 of |error| / acf[0]
+const double schur_max_error = 100;                     // rms error of k, LSB of 8.24 (6e-6)
+const double durbin_max_error = 20000;                  // rms error of k, LSB of 8.24 (1.2e-3)
+const double interpolation_levels[] = { 0.1, 1e-3 };    // peak of the voice
+const double interpolation_min_snr = 110;               // dB
+const double narrow_interpolation_min_snr = 130;        // dB at 0.1, 6 dB less per bit of level
+const int check_host_blocks[] = { 64, 100 };            // samples per processBlock() call
+const int segment_block = 1024;                         // render_block of talkboxRender.cpp
+const int segment_warmup = 128;                         // render_warmup of talkboxRender.cpp
+const double segment_max_deviation = -96;               // dBFS, half an LSB of 16-bit output
+
+static int num_failed = 0;
+
+static void report(bool ok, const char *name, int order, double level, double value, double limit)
+{
+    printf("%-4s %-36s %6d %10.1e %10.1f %10.1f\n", ok ? "ok" : "FAIL", name, order, level, value, limit);
+
+    if (ok == false)
+        num_failed++;
+}
+
+// white noise of the given rms re full scale
+static void makeNoise(int32_t *signal, int n, double level, uint32_t seed)
+{
+    for (int i = 0; i < n; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        signal[i] = (int32_t) (((int32_t) seed / 2147483648.0) * sqrt(3.0) * level * 0x7FFFFFFF);
+    }
+}
+
+// autocorrelation of a smooth (shape 0) and of a resonant spectrum with two
+// formants close to the unit circle (shape 1)
+static void makeAcf(int32_t *r, int order, int shape)
+{
+    for (int i = 0; i <= order; i++)
+    {
+        if (shape == 0)
+            r[i] = (int32_t) (0x7FFFFFFF * exp(-0.02 * i * i / 128.) * cos(0.3 * i));
+        else
+            r[i] = (int32_t) (0x7FFFFFFF * (0.6 * pow(0.995, i) * cos(0.05 * i) + 0.4 * pow(0.99, i) * cos(0.31 * i)));
+    }
+}
+
+// all-pole and reflection coefficients of the spectra of makeAcf()
+static void makeCoefficients(int32_t *a, int32_t *k, int order, int shape)
+{
+    int32_t r[129];
+
+    makeAcf(r, order, shape);
+    durbin32(r, a, order, fractional_digits, k_max, k);
+}
+
+// latticeFilter32 with 64-bit and with 32-bit states against a double lattice
+// with the same coefficients, SNR of the output at levels down to the product
+// of quiet voice and error gain
+static void checkLattice(void)
+{
+    std::vector<int32_t> input(check_signal_length), output(check_signal_length), output_narrow(check_signal_length);
+    std::vector<double> reference(check_signal_length);
+    int32_t a[128], k[128];
+    int64_t memory[128];
+    int32_t memory_narrow[128];
+    double memory_double[128];
+    char name[64];
+
+    for (int order : check_orders)
+    {
+        for (int shape = 0; shape < 2; shape++)
+        {
+            makeCoefficients(a, k, order, shape);
+
+            for (double level : check_levels)
+            {
+                makeNoise(input.data(), check_signal_length, level, 7);
+
+                memset(memory, 0, sizeof(memory));
+                memset(memory_narrow, 0, sizeof(memory_narrow));
+                for (int i = 0; i < check_signal_length; i++)
+                {
+                    output[i] = latticeFilter32(input[i], k, memory, order, fractional_digits);
+                    output_narrow[i] = latticeFilter32(input[i], k, memory_narrow, order, fractional_digits);
+                }
+
+                double scale = ldexp(1, -fractional_digits);
+
+                memset(memory_double, 0, sizeof(memory_double));
+                for (int i = 0; i < check_signal_length; i++)
+                {
+                    double y = input[i];
+
+                    for (int m = order - 1; m >= 0; m--)
+                    {
+                        y -= k[m] * scale * memory_double[m];
+                        if (m + 1 < order)
+                            memory_double[m + 1] = memory_double[m] + k[m] * scale * y;
+                    }
+                    memory_double[0] = y;
+                    reference[i] = y;
+                }
+
+                double signal_energy = 0, error_energy = 0, error_energy_narrow = 0;
+                for (int i = 0; i < check_signal_length; i++)
+                {
+                    double error = output[i] - reference[i];
+                    double error_narrow = output_narrow[i] - reference[i];
+                    signal_energy += reference[i] * reference[i];
+                    error_energy += error * error;
+                    error_energy_narrow += error_narrow * error_narrow;
+                }
+
+                double snr = 10 * log10(signal_energy / error_energy);
+
+                snprintf(name, sizeof(name), "latticeFilter32 %s SNR dB", shape ? "resonant" : "smooth");
+                report(snr >= lattice_min_snr, name, order, level, snr, lattice_min_snr);
+
+                // 32-bit states: the resolution follows the input level
+                double snr_narrow = 10 * log10(signal_energy / error_energy_narrow);
+                double limit_narrow = narrow_lattice_min_snr + 20 * log10(level / 0.02);
+
+                snprintf(name, sizeof(name), "latticeFilter32 narrow %s SNR", shape ? "resonant" : "smooth");
+                report(snr_narrow >= limit_narrow, name, order, level, snr_narrow, limit_narrow);
+            }
+        }
+    }
+}
+
+// lpcFilterCircular32() against lpcFilter32(), and the kernels of simd32.h
+// (fused shiftEnergy32(), shift32() with dotProduct32(), maxAbs32() and
+// autoCorrelation32()) against plain scalar loops, all bit-exact; without
+// -march=native the kernels are the scalar versions and must agree as well
+static void checkBitExact(void)
+{
+    const int shift_lengths[] = { 64, 100, 512, 2047 };
+    const int shifts[] = { 5, 0, -3 };
+    std::vector<int32_t> input(check_signal_length), output(check_signal_length), output_circular(check_signal_length);
+    int32_t a[128], k[128];
+    int32_t memory[128], memory_circular[2 * 128];
+    int32_t signal[2048], fused[2048], separate[2048], reference[2048];
+    int32_t acf[257], acf_reference[257];
+    char name[64];
+
+    for (int order : check_orders)
+    {
+        for (int shape = 0; shape < 2; shape++)
+        {
+            makeCoefficients(a, k, order, shape);
+
+            for (double level : check_levels)
+            {
+                makeNoise(input.data(), check_signal_length, level, 7);
+
+                int position = 0;
+                memset(memory, 0, sizeof(memory));
+                memset(memory_circular, 0, sizeof(memory_circular));
+                for (int i = 0; i < check_signal_length; i++)
+                {
+                    output[i] = lpcFilter32(input[i], a, memory, order, fractional_digits);
+                    output_circular[i] = lpcFilterCircular32(input[i], a, memory_circular, &position, order, fractional_digits);
+                }
+
+                int num_different = 0;
+                for (int i = 0; i < check_signal_length; i++)
+                    if (output_circular[i] != output[i])
+                        num_different++;
+
+                snprintf(name, sizeof(name), "lpcFilterCircular32 %s", shape ? "resonant" : "smooth");
+                report(num_different == 0, name, order, level, num_different, 0);
+            }
+        }
+    }
+
+    // order is the signal length here, level the rms before the shift
+    for (int n : shift_lengths)
+    {
+        for (int n_shift : shifts)
+        {
+            // 0.01 after the shift, so that the energy fits as after the
+            // normalization of calcAutoCoeff32, and one peak that hits
+            // abs(INT32_MIN) where it does not overflow the shift
+            double level = ldexp(0.01, n_shift);
+            makeNoise(signal, n, level, 13);
+            signal[n / 2] = (n_shift > 0) ? INT32_MIN : -(1 << (30 + n_shift));
+
+            int64_t energy_reference = 0;
+            int32_t max_reference = 0;
+            for (int i = 0; i < n; i++)
+            {
+                int32_t abs_value = (int32_t) labs(signal[i]);
+                if (max_reference < abs_value)
+                    max_reference = abs_value;
+
+                reference[i] = (n_shift > 0) ? signal[i] >> n_shift : signal[i] << -n_shift;
+                energy_reference += (int64_t) reference[i] * reference[i];
+            }
+
+            memcpy(fused, signal, n * sizeof(int32_t));
+            int64_t energy_fused = shiftEnergy32(fused, n, n_shift);
+
+            memcpy(separate, signal, n * sizeof(int32_t));
+            int32_t max_value = maxAbs32(separate, n);
+            shift32(separate, n, n_shift);
+            int64_t energy_separate = dotProduct32(separate, separate, n);
+
+            // differing samples, plus one for each differing energy or maximum
+            int num_different = (energy_fused != energy_reference) + (energy_separate != energy_reference)
+                              + (max_value != max_reference);
+            for (int i = 0; i < n; i++)
+                num_different += (fused[i] != reference[i]) + (separate[i] != reference[i]);
+
+            snprintf(name, sizeof(name), "shiftEnergy32 shift %d", n_shift);
+            report(num_different == 0, name, n, level, num_different, 0);
+        }
+    }
+
+    // order is the number of lags here
+    for (int length : acf_lengths)
+    {
+        makeNoise(signal, length, ldexp(1, -8), 17);
+
+        for (int num_lags : acf_lags)
+        {
+            if (num_lags > length)
+                continue;
+
+            autoCorrelation32(acf, num_lags, signal, length, 32);
+
+            for (int j = 0; j < num_lags; j++)
+            {
+                int64_t temp64 = 0;
+                for (int i = 0; i < length - j; i++)
+                    temp64 += (int64_t) signal[i + j] * signal[i];
+                acf_reference[j] = (int32_t) (temp64 >> 32);
+            }
+
+            int num_different = 0;
+            for (int j = 0; j < num_lags; j++)
+                if (acf[j] != acf_reference[j])
+                    num_different++;
+
+            snprintf(name, sizeof(name), "autoCorrelation32 N%d", length);
+            report(num_different == 0, name, num_lags, ldexp(1, -8), num_different, 0);
+        }
+    }
+}
+
+// noise, two tones, silence and a full scale square wave with noise
+static void makeAcfSignal(int32_t *signal, int n, int type)
+{
+    makeNoise(signal, n, acf_signal_levels[type], 11);
+
+    for (int i = 0; i < n; i++)
+    {
+        if (type == 1)
+            signal[i] = (int32_t) (0x7FFFFFFF * (0.3 * sin(0.13 * i) + 0.2 * sin(0.71 * i + 1)));
+        else if (type == 2)
+            signal[i] = 0;
+        else if (type == 3)
+            signal[i] = (i & 16) ? 0x7FFFFFFF - abs(signal[i] >> 4) : -0x7FFFFFFF + abs(signal[i] >> 4);
+    }
+}
+
+// fftAutoCoeff32() against the direct sum, both through calcAutoCoeff32()
+// with the same normalization, on the signals of makeAcfSignal()
+static void checkFftAcf(void)
+{
+    int32_t block[2048], signal[2048], acf_direct[257], acf_fft[257];
+    char name[64];
+
+    for (int type = 0; type < 4; type++)
+    {
+        for (int length : acf_lengths)
+        {
+            makeAcfSignal(block, length, type);
+
+            for (int lags : acf_lags)
+            {
+                if (lags >= length)
+                    continue;
+
+                // calcAutoCoeff32() normalizes the signal in place
+                memcpy(signal, block, length * sizeof(int32_t));
+                calcAutoCoeff32(acf_direct, lags, signal, length, false);
+                memcpy(signal, block, length * sizeof(int32_t));
+                calcAutoCoeff32(acf_fft, lags, signal, length, true);
+
+                double max_error = 0;
+                for (int k = 0; k < lags; k++)
+                    max_error = fmax(max_error, fabs((double) acf_fft[k] - acf_direct[k]));
+
+                // below the LSB of the 1.31 format if both are equal
+                double value = max_error > 0 ? log2(max_error / acf_direct[0]) : -31;
+
+                snprintf(name, sizeof(name), "fftAutoCoeff32 %s %d log2 err", acf_signal_names[type], length);
+                report(value <= acf_max_error, name, lags, acf_signal_levels[type], value, acf_max_error);
+            }
+        }
+    }
+}
+
+// SlidingAutoCoeff32 at hop == BlockLen, where its window is the last block,
+// against calcAutoCoeff32() of that block (the rectangular block ACF of
+// TalkBox32), over four consecutive blocks of the signals of makeAcfSignal()
+template <int num_acf, int length>
+static void checkSlidingAcf(void)
+{
+    const int num_blocks = 4;
+    std::vector<int32_t> signal(num_blocks * length);
+    int32_t block[length], acf_block[num_acf], acf_sliding[num_acf];
+    char name[64];
+
+    for (int type = 0; type < 4; type++)
+    {
+        SlidingAutoCoeff32<num_acf, length> *sliding_acf = new SlidingAutoCoeff32<num_acf, length>;
+        double max_error = 0;
+
+        makeAcfSignal(signal.data(), num_blocks * length, type);
+
+        for (int b = 0; b < num_blocks; b++)
+        {
+            sliding_acf->push(&signal[b * length], length);
+            sliding_acf->get(acf_sliding);
+
+            memcpy(block, &signal[b * length], length * sizeof(int32_t));
+            calcAutoCoeff32(acf_block, num_acf, block, length, false);
+
+            for (int k = 0; k < num_acf; k++)
+                max_error = fmax(max_error, fabs((double) acf_sliding[k] - acf_block[k]));
+        }
+
+        delete sliding_acf;
+
+        // acf[0] is 1 in 1.31 format for both
+        double value = max_error > 0 ? log2(max_error) - 31 : -31;
+
+        snprintf(name, sizeof(name), "SlidingAutoCoeff32 %s log2 err", acf_signal_names[type]);
+        report(value <= sliding_acf_max_error, name, num_acf, acf_signal_levels[type], value, sliding_acf_max_error);
+    }
+}
+
+// carrier saw at 110 Hz and half scale, voice of three harmonics with a
+// slowly moving pitch, so that every analysis frame differs from the last
+static void makeVoice(int32_t *carrier, int32_t *voice, int n, double level, double fs)
+{
+    double phase_carrier = 0, phase_voice = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        phase_carrier += 110 / fs;
+        if (phase_carrier >= 1)
+            phase_carrier -= 1;
+        phase_voice += 180 / fs * (1 + 0.3 * sin(i * 1e-4));
+        if (phase_voice >= 1)
+            phase_voice -= 1;
+
+        double v = (sin(2 * M_PI * phase_voice) + 0.5 * sin(4 * M_PI * phase_voice + 0.3) + 0.25 * sin(6 * M_PI * phase_voice)) / 1.75;
+
+        carrier[i] = (int32_t) ((phase_carrier - 0.5) * 0x7FFFFFFF);
+        voice[i] = (int32_t) (v * level * 0x7FFFFFFF);
+    }
+}
+
+// voice of benchTalkBox32: three harmonics with a 5 Hz vibrato and 5% noise,
+// or noise only, both with a pause of 0.5 s every 1.5 s
+static void makeBenchVoice(int32_t *voice, int n, double level, bool noise_only, double fs)
+{
+    uint32_t seed = 12345;
+    double phase_voice = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        seed = seed * 1664525u + 1013904223u;
+        double noise = ((int32_t) seed) / 2147483648.0;
+
+        phase_voice += 180.0 / fs * (1 + 0.03 * sin(2 * M_PI * 5 * i / fs));
+        if (phase_voice >= 1)
+            phase_voice -= 1;
+
+        double envelope = ((i / (int) (fs * 0.5)) % 3 == 2) ? 0.0 : 1.0;
+        double v = sin(2 * M_PI * phase_voice) + 0.5 * sin(4 * M_PI * phase_voice + 0.3)
+                 + 0.25 * sin(6 * M_PI * phase_voice) + 0.05 * noise;
+
+        voice[i] = (int32_t) ((noise_only ? noise : v) * level * envelope * 0x7FFFFFFF);
+    }
+}
+
+// setInterpolation() of TalkBox32, with 64-bit and with 32-bit lattice states,
+// against a double lattice whose reflection coefficients and gain follow the
+// same linear ramps between the frames, the first second is skipped
+static void checkInterpolation(void)
+{
+    const double fs = 48000;
+    const int n = 10 * (int) fs;
+    const int order = TalkBox32::num_coeffs;
+    std::vector<int32_t> carrier(n), voice(n), output(n);
+    double k[order], k_start[order], k_end[order], memory_double[order];
+    double gain, gain_start, gain_end;
+    char name[64];
+
+    for (int hop : check_hops)
+    {
+        for (int narrow = 0; narrow < 2; narrow++)
+        {
+            for (double level : interpolation_levels)
+            {
+                makeVoice(carrier.data(), voice.data(), n, level, fs);
+
+                TalkBox32 *talkbox = new TalkBox32(fs);
+                talkbox->setHopSize(hop);
+                    talkbox->setInterpolation(true);
+                talkbox->setNarrowLattice(narrow == 1);
+
+                const LPCFrame32<order> *last_frame = 0;
+                int ramp = hop;
+                double signal_energy = 0, error_energy = 0;
+                double scale = ldexp(1, -fractional_digits);
+
+                memset(k, 0, sizeof(k));
+                memset(memory_double, 0, sizeof(memory_double));
+                gain = gain_start = gain_end = 0;
+
+                for (int i = 0; i + hop <= n; i += hop)
+                {
+                    const LPCFrame32<order> *frame = talkbox->getFrame();
+                    talkbox->processBlock(&carrier[i], &voice[i], &output[i], hop);
+
+                    if (frame != last_frame)
+                    {
+                        last_frame = frame;
+                        ramp = 0;
+                        for (int m = 0; m < order; m++)
+                        {
+                            k_start[m] = k[m];
+                            k_end[m] = frame->k32[m] * scale;
+                        }
+                        gain_start = gain;
+                        gain_end = ldexp((double) frame->error_gain * frame->voice_rms, -62);
+                    }
+
+                    for (int j = i; j < i + hop; j++)
+                    {
+                        if (ramp < hop)
+                        {
+                            ramp++;
+                            for (int m = 0; m < order; m++)
+                                k[m] = k_start[m] + (k_end[m] - k_start[m]) * ramp / hop;
+                            gain = gain_start + (gain_end - gain_start) * ramp / hop;
+                        }
+
+                        double y = gain * carrier[j];
+
+                        for (int m = order - 1; m >= 0; m--)
+                        {
+                            y -= k[m] * memory_double[m];
+                            if (m + 1 < order)
+                                memory_double[m + 1] = memory_double[m] + k[m] * y;
+                        }
+                        memory_double[0] = y;
+
+                        if (j >= fs)
+                        {
+                            double error = output[j] - y;
+                            signal_energy += y * y;
+                            error_energy += error * error;
+                        }
+                    }
+
+                    while (talkbox->analyzeNextBlock())
+                        ;
+                }
+
+                delete talkbox;
+
+                double snr = 10 * log10(signal_energy / error_energy);
+                double limit = narrow ? narrow_interpolation_min_snr + 20 * log10(level / 0.1) : interpolation_min_snr;
+
+                snprintf(name, sizeof(name), "%s hop %d SNR dB", narrow ? "setNarrowLattice" : "setInterpolation", hop);
+                report(snr >= limit, name, order, level, snr, limit);
+            }
+        }
+    }
+}
+
+// Levinson recursion in double precision, the reference of durbin32() and
+// schur32(): k[] and the number of stages before |k| > k_max
+static int levinsonDouble(const int32_t *r, double *k, int n)
+{
+    double a[128], a_temp[128];
+    double alpha = r[0];
+
+    for (int i = 0; i < n; i++)
+    {
+        double epsilon = r[i + 1];
+        for (int j = 0; j < i; j++)
+            epsilon += a[j] * r[i - j];
+
+        double ki = -epsilon / alpha;
+        if (fabs(ki) > ldexp(k_max, -31))
+            return i;
+
+        k[i] = ki;
+        for (int j = 0; j < i; j++)
+            a_temp[j] = a[j] + ki * a[i - j - 1];
+        for (int j = 0; j < i; j++)
+            a[j] = a_temp[j];
+        a[i] = ki;
+
+        alpha *= 1 - ki * ki;
+    }
+
+    return n;
+}
+
+// schur32() and durbin32() against the double Levinson recursion on the
+// spectra of makeAcf() (the smooth one exits after the first stage), a voice
+// block, two tones over a noise floor and two tones that leave the ACF nearly
+// singular: rms error of k over the stages computed by all three, and the
+// same stages up to an early exit at |k| > k_max. On the singular ACF durbin32
+// exits early from order 66 on, so only schur32 is checked there
+static void checkSchur(void)
+{
+    const char *acf_names[] = { "smooth", "resonant", "voice", "tones", "singular" };
+    std::vector<int32_t> carrier(2048), voice(2048);
+    int32_t r[129], a[128], k_durbin[128], k_schur[128];
+    double k_reference[128];
+    char name[64];
+
+    for (int order : check_orders)
+    {
+        for (int type = 0; type < 5; type++)
+        {
+            if (type < 2)
+            {
+                makeAcf(r, order, type);
+            }
+            else if (type == 2)
+            {
+                makeVoice(carrier.data(), voice.data(), 2048, 0.1, 48000);
+                calcAutoCoeff32(r, order + 1, voice.data(), 2048, false);
+            }
+            else
+            {
+                double level = (type == 3) ? 0.49 : 0.4999;
+
+                r[0] = 0x7FFFFFFF;
+                for (int i = 1; i <= order; i++)
+                    r[i] = (int32_t) (0x7FFFFFFF * (0.5 * cos(0.2 * i) + level * cos(0.7 * i)));
+            }
+
+            int order_durbin, order_schur;
+            durbin32(r, a, order, fractional_digits, k_max, k_durbin, &order_durbin);
+            schur32(r, a, order, fractional_digits, k_max, k_schur, &order_schur);
+            int order_reference = levinsonDouble(r, k_reference, order);
+
+            // in LSB of the 8.24 format
+            int num_stages = order_reference;
+            if (num_stages > order_durbin)
+                num_stages = order_durbin;
+            if (num_stages > order_schur)
+                num_stages = order_schur;
+
+            double error_durbin = 0, error_schur = 0;
+            for (int i = 0; i < num_stages; i++)
+            {
+                double reference = ldexp(k_reference[i], fractional_digits);
+                error_durbin += (k_durbin[i] - reference) * (k_durbin[i] - reference);
+                error_schur += (k_schur[i] - reference) * (k_schur[i] - reference);
+            }
+            error_durbin = num_stages > 0 ? sqrt(error_durbin / num_stages) : 0;
+            error_schur = num_stages > 0 ? sqrt(error_schur / num_stages) : 0;
+
+            // on the singular ACF the rounding of r[] alone moves k by
+            // thousands of LSB, schur32 is held to the bound of durbin32
+            double limit = (type == 4) ? durbin_max_error : schur_max_error;
+
+            snprintf(name, sizeof(name), "schur32 %s k rms err LSB", acf_names[type]);
+            report(error_schur <= limit, name, order, 1, error_schur, limit);
+
+            snprintf(name, sizeof(name), "schur32 %s stages %d", acf_names[type], order_reference);
+            report(order_schur == order_reference, name, order, 1, order_schur - order_reference, 0);
+
+            if (type == 4)
+                continue;
+
+            snprintf(name, sizeof(name), "durbin32 %s k rms err LSB", acf_names[type]);
+            report(error_durbin <= durbin_max_error, name, order, 1, error_durbin, durbin_max_error);
+
+            snprintf(name, sizeof(name), "durbin32 %s stages %d", acf_names[type], order_reference);
+            report(order_durbin == order_reference, name, order, 1, order_durbin - order_reference, 0);
+        }
+    }
+}
+
+// process() per sample and the interleaved processBlock() against the split
+// processBlock() in host blocks that do not divide the hop, with the analysis
+// inline after each host block, on a voice with a pause of one second that
+// closes the gate; the checks also fail if the pause never reaches the
+// silent path (T is int32_t or float in [-1, 1])
+template <class TB, class T>
+static void checkProcessBlock(const char *engine, double scale)
+{
+    const double fs = 48000;
+    const int n = 4 * (int) fs;
+    std::vector<int32_t> carrier32(n), voice32(n);
+    std::vector<T> carrier(n), voice(n), output_sample(n), output_interleaved(n), output_block(n);
+    const char *mode_names[] = { "direct", "lattice", "ramp" };
+    char name[64];
+
+    makeVoice(carrier32.data(), voice32.data(), n, 0.1, fs);
+
+    for (int i = 0; i < n; i++)
+    {
+        if (i >= 2 * fs && i < 3 * fs)
+            voice32[i] = 0;
+
+        carrier[i] = (T) (carrier32[i] * scale);
+        voice[i] = (T) (voice32[i] * scale);
+    }
+
+    for (int host_block : check_host_blocks)
+    {
+        std::vector<T> interleaved(2 * host_block);
+
+        for (int mode = 0; mode < 3; mode++)
+        {
+            TB *per_sample = new TB(fs);
+            TB *per_block_interleaved = new TB(fs);
+            TB *per_block = new TB(fs);
+
+            for (TB *talkbox : { per_sample, per_block_interleaved, per_block })
+            {
+                talkbox->setGateLevel(0.001f);
+                talkbox->setLatticeFilter(mode == 1);
+                talkbox->setInterpolation(mode == 2);
+            }
+
+            int silent_samples = 0;
+
+            for (int i = 0; i + host_block <= n; i += host_block)
+            {
+                for (int j = i; j < i + host_block; j++)
+                {
+                    T samples[2] = { carrier[j], voice[j] };
+                    per_sample->process(samples);
+                    output_sample[j] = samples[0];
+                }
+                per_sample->calculateLPCcoefficients();
+
+                for (int j = 0; j < host_block; j++)
+                {
+                    interleaved[2 * j] = carrier[i + j];
+                    interleaved[2 * j + 1] = voice[i + j];
+                }
+                per_block_interleaved->processBlock(interleaved.data(), host_block);
+                per_block_interleaved->calculateLPCcoefficients();
+                for (int j = 0; j < host_block; j++)
+                    output_interleaved[i + j] = interleaved[2 * j];
+
+                per_block->processBlock(&carrier[i], &voice[i], &output_block[i], host_block);
+                per_block->calculateLPCcoefficients();
+            }
+
+            delete per_sample;
+            delete per_block_interleaved;
+            delete per_block;
+
+            int num_different = 0, num_different_interleaved = 0;
+
+            for (int i = 0; i < n; i++)
+            {
+                if (output_sample[i] != output_block[i])
+                    num_different++;
+
+                if (output_interleaved[i] != output_block[i])
+                    num_different_interleaved++;
+
+                if (i >= 2 * fs && i < 3 * fs && output_block[i] == 0)
+                    silent_samples++;
+            }
+
+            snprintf(name, sizeof(name), "%s process %s B%d", engine, mode_names[mode], host_block);
+            report(num_different == 0 && silent_samples > 0, name, TB::num_coeffs, 0.1, num_different, 0);
+
+            snprintf(name, sizeof(name), "%s interleaved %s B%d", engine, mode_names[mode], host_block);
+            report(num_different_interleaved == 0 && silent_samples > 0, name, TB::num_coeffs, 0.1,
+                   num_different_interleaved, 0);
+        }
+    }
+}
+
+// renderRange() of talkboxRender.cpp: processBlock() in blocks of
+// segment_block, the analysis after each block
+static void renderSegment(TalkBox32 *talkbox, const int32_t *carrier, const int32_t *voice, int32_t *output,
+                          long start, long end)
+{
+    for (long pos = start; pos < end; pos += segment_block)
+    {
+        int n = (int) ((end - pos < segment_block) ? end - pos : segment_block);
+        talkbox->processBlock(&carrier[pos], &voice[pos], &output[pos], n);
+        talkbox->calculateLPCcoefficients();
+    }
+}
+
+// talkboxRender --threads: segments that start segment_warmup blocks early
+// from reset states against the sequential render, at the default hop (the
+// slowest to converge, fewer frames per block) and without a gate, which
+// would reset the states in the pauses; the worst deviation in the 5 s after
+// three segment starts
+static void checkSegments(void)
+{
+    const double fs = 48000;
+    const long n = (long) (20 * fs) / segment_block * segment_block;
+    std::vector<int32_t> carrier(n), voice(n), sequential(n), segmented(n), unused(n);
+    const char *mode_names[] = { "direct", "lattice", "ramp" };
+    const char *signal_names[] = { "tonal", "voice", "loud", "noise" };
+    const double signal_levels[] = { 0.1, 0.3, 0.55, 0.5 };
+    char name[64];
+
+    for (int type = 0; type < 4; type++)
+    {
+        if (type == 0)
+            makeVoice(carrier.data(), voice.data(), (int) n, signal_levels[type], fs);
+        else
+            makeBenchVoice(voice.data(), (int) n, signal_levels[type], type == 3, fs);
+
+        for (int mode = 0; mode < 3; mode++)
+        {
+            TalkBox32 *talkbox = new TalkBox32(fs);
+            talkbox->setLatticeFilter(mode == 1);
+            talkbox->setInterpolation(mode == 2);
+            renderSegment(talkbox, carrier.data(), voice.data(), sequential.data(), 0, n);
+            delete talkbox;
+
+            double max_deviation = 0;
+
+            for (int k = 1; k < 4; k++)
+            {
+                long start = k * n / 4 / segment_block * segment_block;
+                long end = start + (long) (5 * fs);
+                long warm_start = (start > (long) segment_warmup * segment_block)
+                                ? start - (long) segment_warmup * segment_block : 0;
+
+                talkbox = new TalkBox32(fs);
+                talkbox->setLatticeFilter(mode == 1);
+                talkbox->setInterpolation(mode == 2);
+                renderSegment(talkbox, carrier.data(), voice.data(), unused.data(), warm_start, start);
+                renderSegment(talkbox, carrier.data(), voice.data(), segmented.data(), start, end);
+                delete talkbox;
+
+                for (long i = start; i < end; i++)
+                    max_deviation = fmax(max_deviation, fabs((double) segmented[i] - sequential[i]));
+            }
+
+            double value = (max_deviation > 0) ? 20 * log10(max_deviation / 2147483648.) : -999;
+
+            snprintf(name, sizeof(name), "TalkBox32 segment %s %s dBFS", mode_names[mode], signal_names[type]);
+            report(value <= segment_max_deviation, name, TalkBox32::num_coeffs, signal_levels[type], value,
+                   segment_max_deviation);
+        }
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    if (argc > 1)
+    {
+        fprintf(stderr, "usage: %s\n", argv[0]);
+        return 1;
+    }
+
+    printf("%-4s %-36s %6s %10s %10s %10s\n", "", "check", "order", "level", "value", "limit");
+
+    checkLattice();
+    checkBitExact();
+    checkFftAcf();
+    checkSlidingAcf<TalkBox32LowLatency::num_coeffs + 1, TalkBox32LowLatency::block_length>();
+    checkSlidingAcf<TalkBox32::num_coeffs + 1, TalkBox32::block_length>();
+    checkSlidingAcf<TalkBox32HighOrder::num_coeffs + 1, TalkBox32HighOrder::block_length>();
+    checkSchur();
+    checkInterpolation();
+    checkProcessBlock<TalkBox32, int32_t>("TalkBox32", 1);
+    checkProcessBlock<TalkBoxF32, float>("TalkBoxF32", 1. / 2147483648.);
+    checkSegments();
+
+    printf("%d failed\n", num_failed);
+
+    return num_failed;
+}
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,28 @@
+#ifndef _CYCLE_COUNTER
+#define _CYCLE_COUNTER
+
+#include <stdint.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#elif !defined(__aarch64__)
+#include <chrono>
+#endif
+
+// cheap timestamp for profiling: time stamp counter ticks on x86, virtual
+// counter ticks on aarch64, nanoseconds elsewhere
+inline uint64_t readCycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#elif defined(__aarch64__)
+    uint64_t ticks;
+    asm volatile("mrs %0, cntvct_el0" : "=r" (ticks));
+    return ticks;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+#endif  // _CYCLE_COUNTER
@@ -0,0 +1,246 @@
+#ifndef _DECIMATOR32
+#define _DECIMATOR32
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "simd32.h"
+
+#ifndef M_PI
+#define M_PI    3.14159265358979323846
+#endif
+
+/*---------------------------------------------------------------------------*\
+|   Decimation of the analysis signal by 2 or 4                               |
+|                                                                             |
+|   Polyphase anti-alias FIR: only every factor-th output of the lowpass is   |
+|   computed, decimator_phase_taps multiplications per input sample. The      |
+|   cutoff is 0.45 fs / factor, the coefficients are a hamming windowed sinc  |
+|   in 1.31 format with unity gain at DC.                                     |
+|                                                                             |
+|   interpolateAcf() returns the ACF at the full rate lags from the ACF of    |
+|   the decimated signal: the ACF of the lowpassed signal is band limited to  |
+|   fs / (2 factor) and is interpolated with a windowed sinc. Lags that are   |
+|   multiples of factor are copied, so acf[0] stays 1. The power that the     |
+|   lowpass removed from the block is added back as white noise above the     |
+|   cutoff; without it the ACF has no energy there and the recursion stops    |
+|   at |k| > k_max after a few orders. LPC coefficients from this ACF run at  |
+|   the full rate, the envelope above the cutoff is flat at the measured      |
+|   level.                                                                    |
+\*---------------------------------------------------------------------------*/
+
+const int decimator_max_factor = 4;
+const int decimator_phase_taps = 8;         // taps per polyphase branch
+const int acf_interpolation_taps = 8;       // decimated lags on each side
+const int decimator_energy_shift = 8;       // 2048 squares of 23 bits fit in 64
+
+template <int num_acf, int max_block>
+class Decimator32
+{
+    static const int max_taps = decimator_max_factor * decimator_phase_taps;
+
+    int factor;
+    int n_shift;                            // log2(factor)
+    int num_taps;
+    int32_t coeffs[max_taps];               // time reversed, 1.31 format
+    int32_t weights[decimator_max_factor][2 * acf_interpolation_taps];  // 1.31 format
+    int32_t acf_high[num_acf];              // ACF of white noise above the cutoff, 1.31 format
+    int64_t energy_in;                      // of the last block, shifted by decimator_energy_shift
+    int64_t energy_out;
+
+    // num_taps - 1 past input samples, then the new block
+    int32_t history[max_taps - 1 + max_block];
+
+public:
+    Decimator32(void)
+    {
+        setFactor(1);
+    }
+
+    // power of two, 1..decimator_max_factor, resets the filter states
+    void setFactor(int factor)
+    {
+        this->factor = 1;
+        n_shift = 0;
+        while (this->factor * 2 <= factor && this->factor < decimator_max_factor)
+        {
+            this->factor *= 2;
+            n_shift++;
+        }
+
+        num_taps = decimator_phase_taps * this->factor;
+
+        // lowpass, cutoff 0.45 fs / factor
+        double fc = 0.45 / this->factor;
+        double center = 0.5 * (num_taps - 1);
+        double h[max_taps];
+        double sum = 0;
+
+        for (int i = 0; i < num_taps; i++)
+        {
+            double t = i - center;
+            double window = 0.54 + 0.46 * cos(M_PI * t / (center + 1));
+
+            h[i] = 2 * fc * window;
+            if (t != 0)
+                h[i] *= sin(2 * M_PI * fc * t) / (2 * M_PI * fc * t);
+            sum += h[i];
+        }
+
+        for (int i = 0; i < num_taps; i++)
+            coeffs[num_taps - 1 - i] = (int32_t) (h[i] / sum * 0x7FFFFFFF);
+
+        // interpolation of the lag p / factor between the decimated lags
+        // -acf_interpolation_taps + 1 .. acf_interpolation_taps
+        for (int p = 1; p < this->factor; p++)
+        {
+            double w[2 * acf_interpolation_taps];
+
+            sum = 0;
+            for (int j = 0; j < 2 * acf_interpolation_taps; j++)
+            {
+                double t = (double) p / this->factor - (j - acf_interpolation_taps + 1);
+
+                w[j] = (0.5 + 0.5 * cos(M_PI * t / acf_interpolation_taps)) *
+                       sin(M_PI * t) / (M_PI * t);
+                sum += w[j];
+            }
+
+            for (int j = 0; j < 2 * acf_interpolation_taps; j++)
+                weights[p][j] = (int32_t) (w[j] / sum * 0x7FFFFFFF);
+        }
+
+        // ideal highpass from the cutoff to fs / 2, normalized to acf_high[0] = 1
+        double wc = 2 * M_PI * fc;
+
+        acf_high[0] = 0x7FFFFFFF;
+        for (int k = 1; k < num_acf; k++)
+            acf_high[k] = (int32_t) (-sin(wc * k) / (M_PI * k) / (1 - wc / M_PI) * 0x7FFFFFFF);
+
+        reset();
+    }
+
+    int getFactor(void)
+    {
+        return factor;
+    }
+
+    void reset(void)
+    {
+        for (int i = 0; i < max_taps - 1; i++)
+            history[i] = 0;
+
+        energy_in = energy_out = 0;
+    }
+
+    // lags of the decimated ACF that interpolateAcf() needs
+    int getNumDecimatedLags(void)
+    {
+        return ((num_acf - 1) >> n_shift) + acf_interpolation_taps + 1;
+    }
+
+    // num_in / factor samples to out, which may alias in, num_in is a
+    // multiple of factor and <= max_block, returns max(abs(out))
+    int32_t process(const int32_t *in, int32_t *out, int num_in)
+    {
+        int32_t *x = &history[num_taps - 1];
+        int32_t max_value = 0;
+        int64_t temp64;
+        int32_t temp32;
+
+        memcpy(x, in, num_in * sizeof(int32_t));
+
+        energy_in = 0;
+        for (int i = 0; i < num_in; i++)
+        {
+            temp32 = in[i] >> decimator_energy_shift;
+            energy_in += (int64_t) temp32 * temp32;
+        }
+
+        for (int m = 0; m < (num_in >> n_shift); m++)
+        {
+            // output at the last input sample of the phase
+            temp64 = dotProduct32(coeffs, &history[m * factor + factor - 1], num_taps) >> 31;
+
+            if (temp64 > 0x7FFFFFFF)
+                temp64 = 0x7FFFFFFF;
+            if (temp64 < -0x7FFFFFFF)
+                temp64 = -0x7FFFFFFF;
+
+            temp32 = (int32_t) temp64;
+            out[m] = temp32;
+
+            temp32 = (int32_t) labs(temp32);
+            if (max_value < temp32)
+                max_value = temp32;
+        }
+
+        memmove(history, &x[num_in - (num_taps - 1)], (num_taps - 1) * sizeof(int32_t));
+
+        energy_out = 0;
+        for (int m = 0; m < (num_in >> n_shift); m++)
+        {
+            temp32 = out[m] >> decimator_energy_shift;
+            energy_out += (int64_t) temp32 * temp32;
+        }
+        energy_out <<= n_shift;
+
+        return max_value;
+    }
+
+    // acf[0 .. num_acf - 1] at the full rate from the decimated ACF
+    // acf_decimated[0 .. getNumDecimatedLags() - 1], both normalized
+    void interpolateAcf(const int32_t *acf_decimated, int32_t *acf)
+    {
+        int64_t temp64;
+
+        for (int k = 0; k < num_acf; k++)
+        {
+            int q = k >> n_shift;
+            int p = k & (factor - 1);
+
+            if (p == 0)
+            {
+                acf[k] = acf_decimated[q];
+                continue;
+            }
+
+            // acf is even, negative lags are mirrored
+            temp64 = 0;
+            for (int j = 0; j < 2 * acf_interpolation_taps; j++)
+                temp64 += (int64_t) weights[p][j] * acf_decimated[abs(q + j - acf_interpolation_taps + 1)];
+            temp64 >>= 31;
+
+            if (temp64 > 0x7FFFFFFF)
+                temp64 = 0x7FFFFFFF;
+            if (temp64 < -0x7FFFFFFF)
+                temp64 = -0x7FFFFFFF;
+
+            acf[k] = (int32_t) temp64;
+        }
+
+        // the power the lowpass removed from the last block, as white noise
+        // above the cutoff
+        int64_t total = energy_in;
+        int64_t removed = energy_in - energy_out;
+        int32_t high = 0;
+
+        while (total >= (1LL << 31))
+        {
+            total >>= 1;
+            removed >>= 1;
+        }
+
+        if (removed >= total)
+            high = 0x7FFFFFFF;
+        else if (removed > 0)
+            high = (int32_t) ((removed << 31) / total);
+
+        for (int k = 1; k < num_acf; k++)
+            acf[k] += (int32_t) (((int64_t) high * ((int64_t) acf_high[k] - acf[k])) >> 31);
+    }
+};
+
+#endif  // _DECIMATOR32
@@ -2,7 +2,110 @@
 #define _DURBIN32
 
 #include <stdint.h>
+#include <stdlib.h>
 
-int32_t durbin32(int32_t *r, int32_t *a, int n, int fractional_digits, int32_t k_max);
+/*---------------------------------------------------------------------------*\
+|   Fixed-Point Version of the Durbin Algorithm                               |
+|                                                                             |
+|   Authors:                                                                  |
+|       Finn Bayer, Christoph Eike, Uwe Simmer, 24. Jun. 2016.                |
+|                                                                             |
+|   Reference:                                                                |
+|   [1] Robert Bristow-Johnson,                                               |
+|       Fixed-point implementation of levinson durbin algorithm,              |
+|       comp.dsp, 04.01.2011                                                  |
+\*---------------------------------------------------------------------------*/
+
+// order n <= 128, optionally returns the reflection coefficients in k[n],
+// k[i] = 0 for the stages after an early exit at |k| > k_max, and the
+// number of stages computed in *order (< n after an early exit)
+int32_t durbin32(int32_t *r, int32_t *a, int n, int fractional_digits, int32_t k_max,
+                 int32_t *k = 0, int *order = 0);
+
+// any order, the caller provides the scratch array a_temp[n]
+inline int32_t durbin32(int32_t *r, int32_t *a, int32_t *a_temp, int n,
+                        int fractional_digits, int32_t k_max, int32_t *k = 0,
+                        int *order = 0)
+{
+                            // r, k_max: 1.31 format
+                            // a, a_temp, k: 8.24 format
+    int32_t ki,             // 8.24 format
+            alpha;          // 1.31 format
+    int64_t epsilon;        // 9.55 format
+    int32_t temp32;
+    int i, j;
+
+    // temp32 = 1.0
+    temp32 = 1L << fractional_digits;
+    k_max = (int32_t) (((int64_t) k_max * temp32) >> 31);
+
+    for (i = 0; i < n; i++)
+    {
+        a[i] = 0;
+    }
+
+    if (k)
+    {
+        for (i = 0; i < n; i++)
+            k[i] = 0;
+    }
+
+    alpha = r[0];
+
+    if (order)
+        *order = n;
+
+    for (i = 0; i < n; i++)
+    {
+        /* epsilon = a[0] * r[i]; */
+        epsilon = ((int64_t) r[i+1]) << fractional_digits;
+        for (j = 0; j<i; j++)
+        {
+            epsilon += (int64_t) a[j] * r[i - j];
+        }
+
+        ki = (int32_t) (-epsilon / alpha);
+
+        if (labs(ki) > k_max)
+        {
+            if (order)
+                *order = i;
+            return alpha;
+        }
+
+        a[i] = ki;  // 8.24 format
+
+        if (k)
+            k[i] = ki;
+
+        temp32 = (0x7FFFFFFF - (int32_t) (((int64_t) ki * ki) >> (2 * fractional_digits - 31)));
+
+        alpha = ((int64_t) alpha * temp32) >> 31;
+
+        for (j = 0; j<i; j++)
+        {
+            /* update a[] array into temporary array */
+            a_temp[j] = a[j] + (int32_t) (((int64_t) ki * a[i - j - 1]) >> fractional_digits);
+        }
+
+        for (j = 0; j<i; j++)
+        {
+            /* update a[] array */
+            a[j] = a_temp[j];
+        }
+    }
+
+    return alpha;
+}
+
+// order fixed at compile time
+template <int n>
+inline int32_t durbin32(int32_t *r, int32_t *a, int fractional_digits, int32_t k_max,
+                        int32_t *k = 0, int *order = 0)
+{
+    int32_t a_temp[n];
+
+    return durbin32(r, a, a_temp, n, fractional_digits, k_max, k, order);
+}
 
 #endif  // _DURBIN32
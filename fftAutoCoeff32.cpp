@@ -0,0 +1,241 @@
+#include <math.h>
+#include <stdlib.h>
+#include "fftAutoCoeff32.h"
+#include "log32.h"
+
+#define M_PI    3.14159265358979323846
+
+/* twiddle factors exp(-j*2*pi*k/fft_acf_max_length) in 1.31 format */
+
+struct Twiddles32
+{
+    int32_t re[fft_acf_max_length / 2 + 1];
+    int32_t im[fft_acf_max_length / 2 + 1];
+
+    Twiddles32(void)
+    {
+        for (int k = 0; k <= fft_acf_max_length / 2; k++)
+        {
+            double phi = 2 * M_PI * k / fft_acf_max_length;
+            re[k] = (int32_t) floor( cos(phi) * 0x7FFFFFFF + 0.5);
+            im[k] = (int32_t) floor(-sin(phi) * 0x7FFFFFFF + 0.5);
+        }
+    }
+};
+
+static const Twiddles32 &twiddles(void)
+{
+    static const Twiddles32 table;
+    return table;
+}
+
+/* in-place radix-2 FFT of length n, every stage is scaled by 1/2 */
+
+static void fft32(int32_t *re, int32_t *im, int n)
+{
+    const Twiddles32 &w = twiddles();
+    int32_t temp32;
+    int64_t tr, ti, ar, ai;
+    int i, j, k, bit;
+
+    // bit reversal
+    for (i = 1, j = 0; i < n; i++)
+    {
+        for (bit = n >> 1; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if (i < j)
+        {
+            temp32 = re[i]; re[i] = re[j]; re[j] = temp32;
+            temp32 = im[i]; im[i] = im[j]; im[j] = temp32;
+        }
+    }
+
+    // butterflies
+    for (int len = 2; len <= n; len <<= 1)
+    {
+        int half = len >> 1;
+        int step = fft_acf_max_length / len;
+
+        for (i = 0; i < n; i += len)
+        {
+            for (k = 0; k < half; k++)
+            {
+                int32_t wr = w.re[k * step];
+                int32_t wi = w.im[k * step];
+                int a = i + k;
+                int b = a + half;
+
+                tr = ((int64_t) re[b] * wr - (int64_t) im[b] * wi) >> 31;
+                ti = ((int64_t) re[b] * wi + (int64_t) im[b] * wr) >> 31;
+                ar = re[a];
+                ai = im[a];
+
+                re[a] = (int32_t) ((ar + tr + 1) >> 1);
+                im[a] = (int32_t) ((ai + ti + 1) >> 1);
+                re[b] = (int32_t) ((ar - tr + 1) >> 1);
+                im[b] = (int32_t) ((ai - ti + 1) >> 1);
+            }
+        }
+    }
+}
+
+bool fftAutoCoeff32(int32_t *acf, int num_acf, const int32_t *signal, int num_signal, int n_shift)
+{
+    int32_t re[fft_acf_max_length / 2];
+    int32_t im[fft_acf_max_length / 2];
+    int64_t power[fft_acf_max_length / 2 + 1];
+    const Twiddles32 &w = twiddles();
+    int32_t max_value, abs_value;
+    int64_t temp64, max_power;
+    int i, k, m, log2_m, length, step, scale, p_shift, total_shift;
+
+    // fft length >= num_signal + num_acf - 1 (no circular aliasing),
+    // real fft of length 2 * m as complex fft of length m
+    length = 2;
+    log2_m = 0;
+    while (length < num_signal + num_acf - 1)
+    {
+        length *= 2;
+        log2_m++;
+    }
+
+    if (length > fft_acf_max_length)
+        return false;
+
+    m = length / 2;
+    step = fft_acf_max_length / length;
+
+    // max(abs(signal))
+    max_value = 0;
+    for (i = 0; i < num_signal; i++)
+    {
+        abs_value = labs(signal[i]);
+
+        if (max_value < abs_value)
+            max_value = abs_value;
+    }
+
+    if (max_value == 0)
+    {
+        for (k = 0; k < num_acf; k++)
+            acf[k] = 0;
+        return true;
+    }
+
+    // block floating point, max(abs(signal)) in [2^27, 2^28)
+    scale = nlzs(max_value) - 3;
+
+    // even samples to real part, odd samples to imaginary part
+    for (i = 0; i < m; i++)
+    {
+        re[i] = (2 * i     < num_signal) ? signal[2 * i]     : 0;
+        im[i] = (2 * i + 1 < num_signal) ? signal[2 * i + 1] : 0;
+
+        if (scale >= 0)
+        {
+            re[i] <<= scale;
+            im[i] <<= scale;
+        }
+        else
+        {
+            re[i] >>= -scale;
+            im[i] >>= -scale;
+        }
+    }
+
+    fft32(re, im, m);
+
+    // power spectrum |X[k]|^2, k = 0..m, from the half length spectrum Z:
+    // X[k] = ((Z[k] + Z*[m-k]) - j * W^k * (Z[k] - Z*[m-k])) / 2
+    max_power = 0;
+    for (k = 0; k <= m; k++)
+    {
+        int k0 = (k == m) ? 0 : k;
+        int k1 = (k == 0) ? 0 : m - k;
+
+        int64_t sum_re = (int64_t) re[k0] + re[k1];
+        int64_t sum_im = (int64_t) im[k0] - im[k1];
+        int64_t c_re   = (int64_t) im[k0] + im[k1];     // -j * (Z[k] - Z*[m-k])
+        int64_t c_im   = (int64_t) re[k1] - re[k0];
+
+        int64_t wr = w.re[k * step];
+        int64_t wi = w.im[k * step];
+
+        int64_t x_re = (sum_re + ((wr * c_re - wi * c_im) >> 31) + 1) >> 1;
+        int64_t x_im = (sum_im + ((wr * c_im + wi * c_re) >> 31) + 1) >> 1;
+
+        temp64 = x_re * x_re + x_im * x_im;
+        power[k] = temp64;
+
+        if (max_power < temp64)
+            max_power = temp64;
+    }
+
+    // block floating point, max(power) < 2^29
+    p_shift = 0;
+    while ((max_power >> p_shift) >= (1 << 29))
+        p_shift++;
+
+    for (k = 0; k <= m; k++)
+        power[k] >>= p_shift;
+
+    // inverse real fft: Y[k] = E[k] + j * O[k] with
+    // E[k] = (P[k] + P[m-k]) / 2, O[k] = (P[k] - P[m-k]) / 2 * W^-k
+    for (k = 0; k < m; k++)
+    {
+        int64_t e = (power[k] + power[m - k]) >> 1;
+        int64_t d = (power[k] - power[m - k]) >> 1;
+
+        int64_t o_re = ( d * w.re[k * step]) >> 31;
+        int64_t o_im = (-d * w.im[k * step]) >> 31;
+
+        // conjugated for the inverse transform
+        re[k] =  (int32_t) (e - o_im);
+        im[k] = -(int32_t) o_re;
+    }
+
+    fft32(re, im, m);
+
+    // acf = r * 2^(p_shift + 2 * log2(m) - 2 * scale - n_shift),
+    // r[2n] = Re(y[n]), r[2n+1] = -Im(conj(y[n]))
+    total_shift = p_shift + 2 * log2_m - 2 * scale - n_shift;
+
+    for (k = 0; k < num_acf; k++)
+    {
+        temp64 = (k & 1) ? -(int64_t) im[k >> 1] : (int64_t) re[k >> 1];
+
+        if (total_shift >= 0)
+            acf[k] = (int32_t) (temp64 << total_shift);
+        else
+            acf[k] = (int32_t) (temp64 >> -total_shift);
+    }
+
+    return true;
+}
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,35 @@
+#ifndef _FFT_ACF32
+#define _FFT_ACF32
+
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------*\
+|   FFT-Based Autocorrelation, Block Floating Point                          |
+|                                                                             |
+|   acf[k] = sum(signal[i + k] * signal[i]) >> n_shift for k < num_acf,      |
+|   computed as the inverse FFT of the power spectrum of the zero padded      |
+|   signal. The real FFTs are done as complex FFTs of half length with 1/2    |
+|   scaling per stage.                                                        |
+|                                                                             |
+|   The result is an approximation of the direct sum. For blocks of           |
+|   64..2048 samples normalized as in calcAutoCoeff32() (noise, tones and     |
+|   pulse trains) the error of acf[k] stays below 2^-16 * acf[0]; noise-like  |
+|   signals are about 16 times more accurate than pure tones.                 |
+|                                                                             |
+|   Returns false (and leaves acf untouched) if num_signal + num_acf - 1     |
+|   exceeds fft_acf_max_length.                                               |
+\*---------------------------------------------------------------------------*/
+
+const int fft_acf_max_length = 4096;
+
+// calcAutoCoeff32() switches to the FFT at this number of lags. The direct
+// loop costs num_acf * num_signal, the FFT about num_signal * log2(length),
+// so the break-even depends on num_acf only. It lies at about 512 lags for
+// the AVX2, 256 for the SSE4.1 and 64 for the scalar kernels in
+// calcAutoCoeff32.cpp; one threshold for all builds keeps the choice, and
+// so the coefficients, independent of the compiler flags
+const int fft_acf_min_lags = 256;
+
+bool fftAutoCoeff32(int32_t *acf, int num_acf, const int32_t *signal, int num_signal, int n_shift);
+
+#endif  // _FFT_ACF32
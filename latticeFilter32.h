@@ -0,0 +1,150 @@
+#ifndef _LATTICEFILTER32
+#define _LATTICEFILTER32
+
+#include <stdint.h>
+
+// the stage signals are kept in 64 bits with lattice_fraction bits below the
+// LSB of the samples: quiet inputs keep their resolution through all stages,
+// and the gain of resonant filters has 63 - 31 - lattice_fraction bits of
+// headroom above full scale
+const int lattice_fraction = 16;
+
+// (k * x) >> fractional_digits rounded, x is split at fractional_digits so
+// that no product exceeds 64 bits as long as the result fits
+inline int64_t latticeMultiply(int32_t k, int64_t x, const int fractional_digits)
+{
+    int64_t high = x >> fractional_digits;
+    int64_t low = x & ((1LL << fractional_digits) - 1);
+
+    return k * high + ((k * low + (1LL << (fractional_digits - 1))) >> fractional_digits);
+}
+
+// all-pole lattice filter 1/A(z) with the reflection coefficients k[] of durbin32,
+// memory[m] holds the backward prediction error of stage m delayed by one sample,
+// in 64 bits with lattice_fraction extra fractional bits, stable for |k[m]| < 1
+inline int32_t latticeFilter32(int32_t inputSample, const int32_t *k, int64_t *memory, int num_coeff, const int fractional_digits)
+{
+    int64_t output;
+    int m = num_coeff - 1;
+
+    // the backward error of the last stage is not needed
+    output = ((int64_t) inputSample << lattice_fraction) - latticeMultiply(k[m], memory[m], fractional_digits);
+
+    for (m--; m >= 0; m--)
+    {
+        output -= latticeMultiply(k[m], memory[m], fractional_digits);
+        memory[m + 1] = memory[m] + latticeMultiply(k[m], output, fractional_digits);
+    }
+    memory[0] = output;
+
+    // rounded, wraps around like lpcFilter32 if the output overflows
+    return (int32_t) (uint32_t) ((output + (1LL << (lattice_fraction - 1))) >> lattice_fraction);
+}
+
+// latticeFilter32 on a linear ramp of the reflection coefficients: k64[m] is
+// k[m] with ramp_fraction more bits, each stage first adds step[m] to it, so
+// the ramp costs one add per stage next to the latency-bound recursion
+inline int32_t latticeFilterRamp32(int32_t inputSample, int64_t *k64, const int64_t *step, int64_t *memory,
+                                   int num_coeff, const int fractional_digits, const int ramp_fraction)
+{
+    int64_t output;
+    int32_t k;
+    int m = num_coeff - 1;
+
+    // the low 32 bits of the shift do not depend on the sign fill
+    k64[m] += step[m];
+    k = (int32_t) ((uint64_t) k64[m] >> ramp_fraction);
+    output = ((int64_t) inputSample << lattice_fraction) - latticeMultiply(k, memory[m], fractional_digits);
+
+    for (m--; m >= 0; m--)
+    {
+        k64[m] += step[m];
+        k = (int32_t) ((uint64_t) k64[m] >> ramp_fraction);
+        output -= latticeMultiply(k, memory[m], fractional_digits);
+        memory[m + 1] = memory[m] + latticeMultiply(k, output, fractional_digits);
+    }
+    memory[0] = output;
+
+    return (int32_t) (uint32_t) ((output + (1LL << (lattice_fraction - 1))) >> lattice_fraction);
+}
+
+// the same filters with 32-bit stage states for targets without 64-bit
+// accumulation: one 32 x 32 bit product per multiplication, the states are
+// kept lattice_headroom bits above full scale, so resonant filters overflow
+// less easily but quiet inputs lose resolution
+const int lattice_headroom = 4;
+
+inline int32_t latticeMultiply(int32_t k, int32_t x, const int fractional_digits)
+{
+    return (int32_t) (((int64_t) k * x + (1LL << (fractional_digits - 1))) >> fractional_digits);
+}
+
+inline int32_t latticeFilter32(int32_t inputSample, const int32_t *k, int32_t *memory, int num_coeff, const int fractional_digits)
+{
+    int32_t output;
+    int m = num_coeff - 1;
+
+    output = (inputSample >> lattice_headroom) - latticeMultiply(k[m], memory[m], fractional_digits);
+
+    for (m--; m >= 0; m--)
+    {
+        output -= latticeMultiply(k[m], memory[m], fractional_digits);
+        memory[m + 1] = memory[m] + latticeMultiply(k[m], output, fractional_digits);
+    }
+    memory[0] = output;
+
+    // wraps around like lpcFilter32 if the output overflows
+    return (int32_t) ((uint32_t) output << lattice_headroom);
+}
+
+inline int32_t latticeFilterRamp32(int32_t inputSample, int64_t *k64, const int64_t *step, int32_t *memory,
+                                   int num_coeff, const int fractional_digits, const int ramp_fraction)
+{
+    int32_t output;
+    int32_t k;
+    int m = num_coeff - 1;
+
+    k64[m] += step[m];
+    k = (int32_t) ((uint64_t) k64[m] >> ramp_fraction);
+    output = (inputSample >> lattice_headroom) - latticeMultiply(k, memory[m], fractional_digits);
+
+    for (m--; m >= 0; m--)
+    {
+        k64[m] += step[m];
+        k = (int32_t) ((uint64_t) k64[m] >> ramp_fraction);
+        output -= latticeMultiply(k, memory[m], fractional_digits);
+        memory[m + 1] = memory[m] + latticeMultiply(k, output, fractional_digits);
+    }
+    memory[0] = output;
+
+    return (int32_t) ((uint32_t) output << lattice_headroom);
+}
+
+// filter order fixed at compile time
+template <int num_coeff>
+inline int32_t latticeFilter32(int32_t inputSample, const int32_t *k, int64_t *memory, const int fractional_digits)
+{
+    return latticeFilter32(inputSample, k, memory, num_coeff, fractional_digits);
+}
+
+template <int num_coeff>
+inline int32_t latticeFilterRamp32(int32_t inputSample, int64_t *k64, const int64_t *step, int64_t *memory,
+                                   const int fractional_digits, const int ramp_fraction)
+{
+    return latticeFilterRamp32(inputSample, k64, step, memory, num_coeff, fractional_digits, ramp_fraction);
+}
+
+template <int num_coeff>
+inline int32_t latticeFilter32(int32_t inputSample, const int32_t *k, int32_t *memory, const int fractional_digits)
+{
+    return latticeFilter32(inputSample, k, memory, num_coeff, fractional_digits);
+}
+
+template <int num_coeff>
+inline int32_t latticeFilterRamp32(int32_t inputSample, int64_t *k64, const int64_t *step, int32_t *memory,
+                                   const int fractional_digits, const int ramp_fraction)
+{
+    return latticeFilterRamp32(inputSample, k64, step, memory, num_coeff, fractional_digits, ramp_fraction);
+}
+
+#endif  // _LATTICEFILTER32
@@ -1,6 +1,6 @@
 #include "lpcFilter32.h"
 
-int32_t lpcFilter32(int32_t inputSample, int32_t *a, int32_t *memory, int num_coeff, const int fractional_digits)
+int32_t lpcFilter32(int32_t inputSample, const int32_t *a, int32_t *memory, int num_coeff, const int fractional_digits)
 {
     int32_t output;
     int64_t temp64;
@@ -22,6 +22,109 @@ int32_t lpcFilter32(int32_t inputSample, int32_t *a, int32_t *memory, int num_co
     return output;
 }
 
+#if ( __AVX2__ )
+
+void lpcFilterBank32(const int32_t *input, int32_t *output, const int32_t *a, int32_t *memory, int *position, int num_coeff, int num_voices, int stride, const int fractional_digits)
+{
+    __m128i count = _mm_cvtsi32_si128(fractional_digits);
+    int pos = *position;
+    int new_pos = (pos > 0) ? pos - 1 : num_coeff - 1;
+
+    for (int v = 0; v < num_voices; v += 8)
+    {
+        __m256i acc_even = _mm256_setzero_si256();
+        __m256i acc_odd  = _mm256_setzero_si256();
+
+        // 8 voices per vector, even and odd voices in separate 64-bit lanes
+        for (int i = 0; i < num_coeff; i++)
+        {
+            __m256i va = _mm256_loadu_si256((const __m256i *) &a[i * stride + v]);
+            __m256i vm = _mm256_loadu_si256((const __m256i *) &memory[(pos + i) * stride + v]);
+
+            acc_even = _mm256_add_epi64(acc_even, _mm256_mul_epi32(va, vm));
+            acc_odd  = _mm256_add_epi64(acc_odd,  _mm256_mul_epi32(_mm256_srli_epi64(va, 32),
+                                                                   _mm256_srli_epi64(vm, 32)));
+        }
+
+        // (int32_t) (temp64 >> fractional_digits) are bits fractional_digits..+31,
+        // so a logical shift gives the same result as the arithmetic one
+        __m256i even = _mm256_srl_epi64(acc_even, count);
+        __m256i odd  = _mm256_slli_epi64(_mm256_srl_epi64(acc_odd, count), 32);
+        __m256i out  = _mm256_sub_epi32(_mm256_loadu_si256((const __m256i *) &input[v]),
+                                        _mm256_blend_epi32(even, odd, 0xAA));
+
+        _mm256_storeu_si256((__m256i *) &output[v], out);
+        _mm256_storeu_si256((__m256i *) &memory[new_pos * stride + v], out);
+        _mm256_storeu_si256((__m256i *) &memory[(new_pos + num_coeff) * stride + v], out);
+    }
+
+    *position = new_pos;
+}
+
+#elif ( __SSE4_1__ )
+
+void lpcFilterBank32(const int32_t *input, int32_t *output, const int32_t *a, int32_t *memory, int *position, int num_coeff, int num_voices, int stride, const int fractional_digits)
+{
+    __m128i count = _mm_cvtsi32_si128(fractional_digits);
+    int pos = *position;
+    int new_pos = (pos > 0) ? pos - 1 : num_coeff - 1;
+
+    for (int v = 0; v < num_voices; v += 4)
+    {
+        __m128i acc_even = _mm_setzero_si128();
+        __m128i acc_odd  = _mm_setzero_si128();
+
+        // 4 voices per vector, even and odd voices in separate 64-bit lanes
+        for (int i = 0; i < num_coeff; i++)
+        {
+            __m128i va = _mm_loadu_si128((const __m128i *) &a[i * stride + v]);
+            __m128i vm = _mm_loadu_si128((const __m128i *) &memory[(pos + i) * stride + v]);
+
+            acc_even = _mm_add_epi64(acc_even, _mm_mul_epi32(va, vm));
+            acc_odd  = _mm_add_epi64(acc_odd,  _mm_mul_epi32(_mm_srli_epi64(va, 32),
+                                                             _mm_srli_epi64(vm, 32)));
+        }
+
+        // (int32_t) (temp64 >> fractional_digits) are bits fractional_digits..+31,
+        // so a logical shift gives the same result as the arithmetic one
+        __m128i even = _mm_srl_epi64(acc_even, count);
+        __m128i odd  = _mm_slli_epi64(_mm_srl_epi64(acc_odd, count), 32);
+        __m128i out  = _mm_sub_epi32(_mm_loadu_si128((const __m128i *) &input[v]),
+                                     _mm_blend_epi16(even, odd, 0xCC));
+
+        _mm_storeu_si128((__m128i *) &output[v], out);
+        _mm_storeu_si128((__m128i *) &memory[new_pos * stride + v], out);
+        _mm_storeu_si128((__m128i *) &memory[(new_pos + num_coeff) * stride + v], out);
+    }
+
+    *position = new_pos;
+}
+
+#else
+
+void lpcFilterBank32(const int32_t *input, int32_t *output, const int32_t *a, int32_t *memory, int *position, int num_coeff, int num_voices, int stride, const int fractional_digits)
+{
+    int64_t temp64;
+    int pos = *position;
+    int new_pos = (pos > 0) ? pos - 1 : num_coeff - 1;
+
+    for (int v = 0; v < num_voices; v++)
+    {
+        temp64 = 0;
+        for (int i = 0; i < num_coeff; i++)
+            temp64 += (int64_t) a[i * stride + v] * memory[(pos + i) * stride + v];
+
+        output[v] = input[v] - (int32_t) (temp64 >> fractional_digits);
+
+        memory[new_pos * stride + v] = output[v];
+        memory[(new_pos + num_coeff) * stride + v] = output[v];
+    }
+
+    *position = new_pos;
+}
+
+#endif
+
 //--------------------- License ------------------------------------------------
 
 // Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
@@ -3,6 +3,50 @@
 
 #include <stdint.h>
 
-int32_t lpcFilter32(int32_t inputSample, int32_t *a, int32_t *memory, int num_coeff, const int fractional_digits);
+#include "simd32.h"
+
+int32_t lpcFilter32(int32_t inputSample, const int32_t *a, int32_t *memory, int num_coeff, const int fractional_digits);
+
+// same filter with a mirrored circular history of 2 * num_coeff samples,
+// memory[*position + i] holds the output delayed by i + 1 samples
+inline int32_t lpcFilterCircular32(int32_t inputSample, const int32_t *a, int32_t *memory, int *position, int num_coeff, const int fractional_digits)
+{
+    int32_t output;
+    int64_t temp64;
+    int pos = *position;
+
+    // the history is contiguous from memory[pos], no shifting needed
+    temp64 = dotProduct32(a, &memory[pos], num_coeff);
+
+    output = (int32_t)(temp64 >> fractional_digits);
+    output = inputSample - output;
+
+    // new output at the front of the window and in its mirror copy
+    pos--;
+    if (pos < 0)
+        pos += num_coeff;
+
+    memory[pos] = output;
+    memory[pos + num_coeff] = output;
+
+    *position = pos;
+
+    return output;
+}
+
+// filter order fixed at compile time
+template <int num_coeff>
+inline int32_t lpcFilterCircular32(int32_t inputSample, const int32_t *a, int32_t *memory, int *position, const int fractional_digits)
+{
+    return lpcFilterCircular32(inputSample, a, memory, position, num_coeff, fractional_digits);
+}
+
+// the same filter for many independent voices at once (structure of arrays):
+// a[k * stride + v], memory[(*position + k) * stride + v], stride is a multiple
+// of lpc_bank_lanes, input[v] and output[v] hold one sample of every voice;
+// only the vectors that hold one of the num_voices voices are filtered
+const int lpc_bank_lanes = 8;
+
+void lpcFilterBank32(const int32_t *input, int32_t *output, const int32_t *a, int32_t *memory, int *position, int num_coeff, int num_voices, int stride, const int fractional_digits);
 
 #endif  // _LPCFILTER32
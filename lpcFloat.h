@@ -0,0 +1,136 @@
+#ifndef _LPC_FLOAT
+#define _LPC_FLOAT
+
+#include <limits>
+
+#include "simdFloat.h"
+
+/*---------------------------------------------------------------------------*\
+|   Floating-point versions of calcAutoCoeff32, durbin32, lpcFilterCircular32 |
+|   and latticeFilter32 for float and double, with the same conventions:      |
+|   A(z) = 1 + a[0] z^-1 + ... + a[n-1] z^-n, the synthesis filter is 1/A(z). |
+\*---------------------------------------------------------------------------*/
+
+// normalized autocorrelation acf[k] = sum(signal[i + k] * signal[i]) / acf[0],
+// acf = 1, 0, 0, ... for a silent block
+template <class T>
+inline void calcAutoCoeffFloat(T *acf, int num_acf, const T *signal, int num_signal)
+{
+    autoCorrelationFloat(acf, num_acf, signal, num_signal);
+
+    if (acf[0] < std::numeric_limits<T>::min())
+    {
+        acf[0] = 1;
+        for (int k = 1; k < num_acf; k++)
+            acf[k] = 0;
+        return;
+    }
+
+    T inv_energy = 1 / acf[0];
+
+    acf[0] = 1;
+    for (int k = 1; k < num_acf; k++)
+        acf[k] *= inv_energy;
+}
+
+// Levinson-Durbin recursion, returns the prediction error power,
+// k[n] gets the reflection coefficients (0 after an early exit at |k| > k_max),
+// the caller provides the scratch array temp[2 * n]
+template <class T>
+inline T durbinFloat(const T *r, T *a, T *k, T *temp, int n, T k_max)
+{
+    // a reversed copy of a[] and of r[1..n], so that the
+    // sums and updates over a[i - j] run forward in memory
+    T *a_reverse = temp;        // a_reverse[n - 1 - j] = a[j]
+    T *r_reverse = &temp[n];    // r_reverse[n - 1 - j] = r[j + 1]
+    T alpha, epsilon, ki;
+    int i, j;
+
+    for (i = 0; i < n; i++)
+    {
+        a[i] = 0;
+        k[i] = 0;
+        a_reverse[i] = 0;
+        r_reverse[n - 1 - i] = r[i + 1];
+    }
+
+    alpha = r[0];
+
+    for (i = 0; i < n; i++)
+    {
+        // epsilon = r[i + 1] + sum(a[j] * r[i - j])
+        epsilon = r[i + 1] + dotProductFloat(a, &r_reverse[n - i], i);
+
+        ki = -epsilon / alpha;
+
+        if (ki > k_max || ki < -k_max)
+            return alpha;
+
+        alpha *= 1 - ki * ki;
+
+        // a[j] += ki * a[i - 1 - j] for both copies, independent for every j
+        for (j = 0; j < i; j++)
+        {
+            T aj = a[j];
+            T ar = a_reverse[n - i + j];
+
+            a[j] = aj + ki * ar;
+            a_reverse[n - i + j] = ar + ki * aj;
+        }
+
+        a[i] = ki;
+        a_reverse[n - 1 - i] = ki;
+        k[i] = ki;
+    }
+
+    return alpha;
+}
+
+// order fixed at compile time
+template <int n, class T>
+inline T durbinFloat(const T *r, T *a, T *k, T k_max)
+{
+    T temp[2 * n];
+
+    return durbinFloat(r, a, k, temp, n, k_max);
+}
+
+// direct form all-pole filter with a mirrored circular history of 2 * num_coeff
+// samples, memory[*position + i] holds the output delayed by i + 1 samples
+template <class T>
+inline T lpcFilterCircularFloat(T inputSample, const T *a, T *memory, int *position, int num_coeff)
+{
+    int pos = *position;
+    T output = inputSample - dotProductFloat(a, &memory[pos], num_coeff);
+
+    pos--;
+    if (pos < 0)
+        pos += num_coeff;
+
+    memory[pos] = output;
+    memory[pos + num_coeff] = output;
+
+    *position = pos;
+
+    return output;
+}
+
+// all-pole lattice filter with the reflection coefficients k[],
+// memory[m] holds the backward prediction error of stage m delayed by one sample
+template <class T>
+inline T latticeFilterFloat(T inputSample, const T *k, T *memory, int num_coeff)
+{
+    int m = num_coeff - 1;
+    T output = inputSample - k[m] * memory[m];
+
+    for (m--; m >= 0; m--)
+    {
+        output -= k[m] * memory[m];
+        memory[m + 1] = memory[m] + k[m] * output;
+    }
+    memory[0] = output;
+
+    return output;
+}
+
+#endif  // _LPC_FLOAT
@@ -0,0 +1,178 @@
+#include <string.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "lpcFrameFile32.h"
+
+LPCFrameWriter32::LPCFrameWriter32(void)
+{
+    file = 0;
+    memset(&header, 0, sizeof(header));
+}
+
+LPCFrameWriter32::~LPCFrameWriter32(void)
+{
+    close();
+}
+
+bool LPCFrameWriter32::open(const char *path, int order, int hop_size, int block_length,
+                            int fractional_digits, double fs)
+{
+    close();
+
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, lpc_file_magic, sizeof(header.magic));
+    header.version = lpc_file_version;
+    header.header_size = sizeof(header);
+    header.frame_size = (uint32_t) (sizeof(uint64_t) + (2 + 2 * order) * sizeof(int32_t));
+    header.order = order;
+    header.hop_size = hop_size;
+    header.block_length = block_length;
+    header.fractional_digits = fractional_digits;
+    header.fs = fs;
+    header.num_frames = 0;
+
+    file = fopen(path, "wb");
+    if (file == 0)
+        return false;
+
+    // num_frames is written again by close()
+    if (fwrite(&header, sizeof(header), 1, file) != 1)
+    {
+        fclose(file);
+        file = 0;
+        return false;
+    }
+
+    return true;
+}
+
+bool LPCFrameWriter32::write(uint64_t timestamp, const int32_t *a32, const int32_t *k32,
+                             int32_t error_gain, int32_t voice_rms)
+{
+    int32_t gains[2] = { error_gain, voice_rms };
+
+    if (file == 0)
+        return false;
+
+    if (fwrite(&timestamp, sizeof(timestamp), 1, file) != 1 ||
+        fwrite(gains, sizeof(gains), 1, file) != 1 ||
+        fwrite(a32, sizeof(int32_t), header.order, file) != header.order ||
+        fwrite(k32, sizeof(int32_t), header.order, file) != header.order)
+        return false;
+
+    header.num_frames++;
+    return true;
+}
+
+bool LPCFrameWriter32::close(void)
+{
+    bool ok;
+
+    if (file == 0)
+        return true;
+
+    ok = fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1, file) == 1;
+    ok = (fclose(file) == 0) && ok;
+    file = 0;
+
+    return ok;
+}
+
+LPCFrameReader32::LPCFrameReader32(void)
+{
+    map = 0;
+    map_size = 0;
+    header = 0;
+    frames = 0;
+}
+
+LPCFrameReader32::~LPCFrameReader32(void)
+{
+    close();
+}
+
+bool LPCFrameReader32::open(const char *path)
+{
+    struct stat st;
+
+    close();
+
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(LPCFileHeader32))
+    {
+        ::close(fd);
+        return false;
+    }
+
+    map_size = st.st_size;
+    map = (uint8_t *) mmap(0, map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+
+    if (map == MAP_FAILED)
+    {
+        map = 0;
+        return false;
+    }
+
+    const LPCFileHeader32 *h = (const LPCFileHeader32 *) map;
+
+    // the records must fit the file and the frame size the order
+    if (memcmp(h->magic, lpc_file_magic, sizeof(h->magic)) != 0 ||
+        h->version != lpc_file_version ||
+        h->header_size < sizeof(LPCFileHeader32) || h->header_size % 8 != 0 ||
+        h->frame_size < sizeof(uint64_t) + (2 + 2 * h->order) * sizeof(int32_t) ||
+        h->frame_size % 8 != 0 || h->header_size > map_size ||
+        h->num_frames > (map_size - h->header_size) / h->frame_size)
+    {
+        close();
+        return false;
+    }
+
+    header = h;
+    frames = map + h->header_size;
+
+    return true;
+}
+
+void LPCFrameReader32::close(void)
+{
+    if (map)
+        munmap(map, map_size);
+
+    map = 0;
+    map_size = 0;
+    header = 0;
+    frames = 0;
+}
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
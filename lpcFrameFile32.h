@@ -0,0 +1,94 @@
+#ifndef _LPC_FRAME_FILE32
+#define _LPC_FRAME_FILE32
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+
+#include "lpcFrameStream32.h"
+
+/*---------------------------------------------------------------------------*\
+|   Binary file of LPC analysis frames for record and replay                  |
+|                                                                             |
+|   header (64 bytes), then num_frames records of frame_size bytes:           |
+|       uint64_t timestamp      sample position at the end of the hop         |
+|       int32_t  error_gain     1.31 format                                   |
+|       int32_t  voice_rms      1.31 format                                   |
+|       int32_t  a32[order]     fractional_digits                             |
+|       int32_t  k32[order]     fractional_digits                             |
+|                                                                             |
+|   Native byte order (little endian on all targets so far), the records are  |
+|   8-byte aligned so that the file can be used memory mapped.                |
+\*---------------------------------------------------------------------------*/
+
+const char lpc_file_magic[8] = { 'T', 'B', 'L', 'P', 'C', '3', '2', 0 };
+const uint32_t lpc_file_version = 1;
+
+struct LPCFileHeader32
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t header_size;           // offset of the first record
+    uint32_t frame_size;            // bytes per record
+    uint32_t order;
+    uint32_t hop_size;
+    uint32_t block_length;
+    uint32_t fractional_digits;
+    uint32_t reserved;
+    double fs;
+    uint64_t num_frames;
+    uint8_t padding[8];
+};
+
+static_assert(sizeof(LPCFileHeader32) == 64, "LPCFileHeader32 must have 64 bytes");
+
+// sequential writer, the header is completed by close()
+class LPCFrameWriter32 : public LPCFrameSink32
+{
+protected:
+    FILE *file;
+    LPCFileHeader32 header;
+
+public:
+    LPCFrameWriter32(void);
+    ~LPCFrameWriter32(void);
+    bool open(const char *path, int order, int hop_size, int block_length,
+              int fractional_digits, double fs);
+    bool write(uint64_t timestamp, const int32_t *a32, const int32_t *k32,
+               int32_t error_gain, int32_t voice_rms) override;
+    bool close(void);
+};
+
+// memory mapped reader, the frames are accessed in place
+class LPCFrameReader32 : public LPCFrameSource32
+{
+protected:
+    uint8_t *map;
+    size_t map_size;
+    const LPCFileHeader32 *header;
+    const uint8_t *frames;
+
+    const int32_t *record(uint64_t index)
+    {
+        return (const int32_t *) (frames + index * header->frame_size);
+    }
+
+public:
+    LPCFrameReader32(void);
+    ~LPCFrameReader32(void);
+    bool open(const char *path);
+    void close(void);
+    const LPCFileHeader32 *getHeader(void) { return header; }
+    int getOrder(void) override             { return header ? (int) header->order : 0; }
+    int getHopSize(void) override           { return header ? (int) header->hop_size : 0; }
+    int getFractionalDigits(void) override  { return header ? (int) header->fractional_digits : 0; }
+    uint64_t getNumFrames(void) override    { return header ? header->num_frames : 0; }
+
+    uint64_t getTimestamp(uint64_t index) override { return *(const uint64_t *) record(index); }
+    int32_t getErrorGain(uint64_t index) override  { return record(index)[2]; }
+    int32_t getVoiceRms(uint64_t index) override   { return record(index)[3]; }
+    const int32_t *getA32(uint64_t index) override { return &record(index)[4]; }
+    const int32_t *getK32(uint64_t index) override { return &record(index)[4 + header->order]; }
+};
+
+#endif  // _LPC_FRAME_FILE32
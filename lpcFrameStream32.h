@@ -0,0 +1,40 @@
+#ifndef _LPC_FRAME_STREAM32
+#define _LPC_FRAME_STREAM32
+
+#include <stdint.h>
+
+// interfaces between the analysis of a TalkBox and a store of its frames,
+// implemented outside the core (lpcFrameFile32.h for files), both are
+// called from the analysis side only
+
+// receives every analysis frame, timestamp is the sample position at the
+// end of the hop
+class LPCFrameSink32
+{
+public:
+    virtual ~LPCFrameSink32(void) {}
+
+    virtual bool write(uint64_t timestamp, const int32_t *a32, const int32_t *k32,
+                       int32_t error_gain, int32_t voice_rms) = 0;
+};
+
+// recorded frames in the order of their timestamps, a32 and k32 have
+// getOrder() coefficients with getFractionalDigits()
+class LPCFrameSource32
+{
+public:
+    virtual ~LPCFrameSource32(void) {}
+
+    virtual int getOrder(void) = 0;
+    virtual int getHopSize(void) = 0;
+    virtual int getFractionalDigits(void) = 0;
+    virtual uint64_t getNumFrames(void) = 0;
+
+    virtual uint64_t getTimestamp(uint64_t index) = 0;
+    virtual int32_t getErrorGain(uint64_t index) = 0;
+    virtual int32_t getVoiceRms(uint64_t index) = 0;
+    virtual const int32_t *getA32(uint64_t index) = 0;
+    virtual const int32_t *getK32(uint64_t index) = 0;
+};
+
+#endif  // _LPC_FRAME_STREAM32
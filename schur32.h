@@ -0,0 +1,126 @@
+#ifndef _SCHUR32
+#define _SCHUR32
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*---------------------------------------------------------------------------*\
+|   Fixed-Point Version of the Schur Algorithm                                |
+|                                                                             |
+|   Same interface and results as durbin32: the reflection coefficients are   |
+|   computed from the two generator sequences e[], f[] of the lattice, which  |
+|   stay bounded by r[0] in 1.31 format, the direct form coefficients follow  |
+|   by the step-up recursion. One 64/32 division per stage, the inner loops   |
+|   are independent multiply-adds and need no copy of a[].                    |
+|                                                                             |
+|   Reference:                                                                |
+|   [1] J. Le Roux, C. Gueguen,                                               |
+|       A fixed point computation of partial correlation coefficients,        |
+|       IEEE Trans. ASSP, vol. 25, no. 3, pp. 257-259, June 1977              |
+\*---------------------------------------------------------------------------*/
+
+// order n <= 128, arguments and return value as in durbin32
+int32_t schur32(int32_t *r, int32_t *a, int n, int fractional_digits, int32_t k_max,
+                int32_t *k = 0, int *order = 0);
+
+// any order, the caller provides the scratch array temp[2 * n + 2]
+inline int32_t schur32(int32_t *r, int32_t *a, int32_t *temp, int n,
+                       int fractional_digits, int32_t k_max, int32_t *k = 0,
+                       int *order = 0)
+{
+                            // r, k_max, e, f, ki: 1.31 format
+                            // a, k: 8.24 format
+    int32_t *e = temp;              // forward generator e[n + 1]
+    int32_t *f = &temp[n + 1];      // backward generator f[n + 1]
+    int32_t ki;
+    int i, j, m;
+
+    for (i = 0; i < n; i++)
+    {
+        a[i] = 0;
+    }
+
+    if (k)
+    {
+        for (i = 0; i < n; i++)
+            k[i] = 0;
+    }
+
+    for (j = 0; j <= n; j++)
+    {
+        e[j] = r[j];
+        f[j] = r[j];
+    }
+
+    if (order)
+        *order = n;
+
+    // f[i] is the prediction error power alpha of order i
+    for (i = 0; i < n; i++)
+    {
+        if (f[i] <= 0)
+        {
+            ki = 0x7FFFFFFF;
+        }
+        else
+        {
+            int64_t temp64 = -(((int64_t) e[i + 1]) << 31) / f[i];
+
+            if (temp64 > 0x7FFFFFFF)
+                temp64 = 0x7FFFFFFF;
+            if (temp64 < -0x7FFFFFFF)
+                temp64 = -0x7FFFFFFF;
+
+            ki = (int32_t) temp64;
+        }
+
+        if (labs(ki) > k_max)
+        {
+            if (order)
+                *order = i;
+            return f[i];
+        }
+
+        if (k)
+            k[i] = ki >> (31 - fractional_digits);
+
+        // stage i + 1 of both generators, descending so that the update
+        // works in place on the old f[j - 1]
+        for (j = n; j > i; j--)
+        {
+            int32_t ej = e[j];
+            int32_t fj = f[j - 1];
+
+            e[j] = ej + (int32_t) (((int64_t) ki * fj) >> 31);
+            f[j] = fj + (int32_t) (((int64_t) ki * ej) >> 31);
+        }
+
+        // step-up recursion a[j] += ki * a[i - 1 - j], pairwise in place
+        for (j = 0, m = i - 1; j < m; j++, m--)
+        {
+            int32_t aj = a[j];
+            int32_t am = a[m];
+
+            a[j] = aj + (int32_t) (((int64_t) ki * am) >> 31);
+            a[m] = am + (int32_t) (((int64_t) ki * aj) >> 31);
+        }
+        if (j == m)
+            a[j] += (int32_t) (((int64_t) ki * a[j]) >> 31);
+
+        a[i] = ki >> (31 - fractional_digits);
+    }
+
+    return f[n];
+}
+
+// order fixed at compile time
+template <int n>
+inline int32_t schur32(int32_t *r, int32_t *a, int fractional_digits, int32_t k_max,
+                       int32_t *k = 0, int *order = 0)
+{
+    int32_t temp[2 * n + 2];
+
+    return schur32(r, a, temp, n, fractional_digits, k_max, k, order);
+}
+
+#endif  // _SCHUR32
@@ -0,0 +1,197 @@
+#ifndef __SIMD16__
+#define __SIMD16__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "simd32.h"
+
+//------------------------------------------------------------------------------
+// 16-bit kernels of the Q15 engine
+//
+// 16 x 16 -> 32 bit multiply-add of sample pairs (pmaddwd), twice the lanes of
+// the 32-bit kernels per vector. The pair sums are widened to 64 bits before
+// they can overflow, so all versions return exactly the scalar result.
+
+#if ( __AVX2__ )
+
+// the eight 32-bit lanes of p added to the four 64-bit lanes of acc
+inline __m256i widenAdd16(__m256i acc, __m256i p)
+{
+    acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(p)));
+    return _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(p, 1)));
+}
+
+inline int64_t dotProduct16(const int16_t *a, const int16_t *b, int n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i;
+
+    for (i = 0; i + 16 <= n; i += 16)
+        acc = widenAdd16(acc, _mm256_madd_epi16(_mm256_loadu_si256((const __m256i *) &a[i]),
+                                                _mm256_loadu_si256((const __m256i *) &b[i])));
+
+    int64_t temp64 = sum64(acc);
+
+    for (; i < n; i++)
+        temp64 += (int32_t) a[i] * b[i];
+
+    return temp64;
+}
+
+
+#elif ( __SSE4_1__ )
+
+inline __m128i widenAdd16(__m128i acc, __m128i p)
+{
+    acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(p));
+    return _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(p, 8)));
+}
+
+inline int64_t dotProduct16(const int16_t *a, const int16_t *b, int n)
+{
+    __m128i acc = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+        acc = widenAdd16(acc, _mm_madd_epi16(_mm_loadu_si128((const __m128i *) &a[i]),
+                                             _mm_loadu_si128((const __m128i *) &b[i])));
+
+    int64_t temp64 = sum64(acc);
+
+    for (; i < n; i++)
+        temp64 += (int32_t) a[i] * b[i];
+
+    return temp64;
+}
+
+
+#else
+
+inline int64_t dotProduct16(const int16_t *a, const int16_t *b, int n)
+{
+    int64_t temp64 = 0;
+
+    for (int i = 0; i < n; i++)
+        temp64 += (int32_t) a[i] * b[i];
+
+    return temp64;
+}
+
+
+#endif
+
+//------------------------------------------------------------------------------
+// x[i] >> n_shift (or << -n_shift) saturated to |y[i]| < 2^14, the bit of
+// headroom keeps the pair sums of pmaddwd below 2^29
+
+inline void shiftTo16(const int32_t *x, int16_t *y, int n, int n_shift)
+{
+    int32_t temp32;
+
+    for (int i = 0; i < n; i++)
+    {
+        temp32 = (n_shift > 0) ? x[i] >> n_shift : x[i] << -n_shift;
+
+        if (temp32 > 0x3FFF)
+            temp32 = 0x3FFF;
+        if (temp32 < -0x3FFF)
+            temp32 = -0x3FFF;
+
+        y[i] = (int16_t) temp32;
+    }
+}
+
+//------------------------------------------------------------------------------
+// autocorrelation acf[k] = sum(signal[i + k] * signal[i]), k < num_acf, for
+// |signal| < 2^14: a 32-bit lane then holds four pair sums, so the lanes are
+// widened every acf16_steps vectors only. Four lags at a time as
+// autoCorrelation32, identical results for all versions.
+
+const int acf16_steps = 4;
+
+#if ( __AVX2__ ) || ( __SSE4_1__ )
+
+#if ( __AVX2__ )
+
+#define VEC16           __m256i
+#define VEC16_LANES     16
+#define VEC16_ZERO()    _mm256_setzero_si256()
+#define VEC16_LOAD(p)   _mm256_loadu_si256((const __m256i *) (p))
+#define VEC16_ADD32(a, b) _mm256_add_epi32(a, b)
+#define VEC16_MADD(a, b)  _mm256_madd_epi16(a, b)
+
+#else
+
+#define VEC16           __m128i
+#define VEC16_LANES     8
+#define VEC16_ZERO()    _mm_setzero_si128()
+#define VEC16_LOAD(p)   _mm_loadu_si128((const __m128i *) (p))
+#define VEC16_ADD32(a, b) _mm_add_epi32(a, b)
+#define VEC16_MADD(a, b)  _mm_madd_epi16(a, b)
+
+#endif
+
+inline void autoCorrelation16(int64_t *acf, int num_acf, const int16_t *signal, int num_signal)
+{
+    int i, j, k, n, step;
+
+    for (k = 0; k + 4 <= num_acf; k += 4)
+    {
+        VEC16 acc0 = VEC16_ZERO(), acc1 = VEC16_ZERO(), acc2 = VEC16_ZERO(), acc3 = VEC16_ZERO();
+
+        // common range of lags k..k+3
+        n = num_signal - k - 3;
+
+        for (i = 0; i + VEC16_LANES <= n; )
+        {
+            VEC16 p0 = VEC16_ZERO(), p1 = VEC16_ZERO(), p2 = VEC16_ZERO(), p3 = VEC16_ZERO();
+
+            for (step = 0; step < acf16_steps && i + VEC16_LANES <= n; step++, i += VEC16_LANES)
+            {
+                VEC16 x = VEC16_LOAD(&signal[i]);
+
+                p0 = VEC16_ADD32(p0, VEC16_MADD(x, VEC16_LOAD(&signal[i + k])));
+                p1 = VEC16_ADD32(p1, VEC16_MADD(x, VEC16_LOAD(&signal[i + k + 1])));
+                p2 = VEC16_ADD32(p2, VEC16_MADD(x, VEC16_LOAD(&signal[i + k + 2])));
+                p3 = VEC16_ADD32(p3, VEC16_MADD(x, VEC16_LOAD(&signal[i + k + 3])));
+            }
+
+            acc0 = widenAdd16(acc0, p0);
+            acc1 = widenAdd16(acc1, p1);
+            acc2 = widenAdd16(acc2, p2);
+            acc3 = widenAdd16(acc3, p3);
+        }
+
+        acf[k] = sum64(acc0);
+        acf[k + 1] = sum64(acc1);
+        acf[k + 2] = sum64(acc2);
+        acf[k + 3] = sum64(acc3);
+
+        for (j = 0; j < 4; j++)
+            for (n = i; n < num_signal - k - j; n++)
+                acf[k + j] += (int32_t) signal[n + k + j] * signal[n];
+    }
+
+    for (; k < num_acf; k++)
+        acf[k] = dotProduct16(signal, &signal[k], num_signal - k);
+}
+
+#undef VEC16
+#undef VEC16_LANES
+#undef VEC16_ZERO
+#undef VEC16_LOAD
+#undef VEC16_ADD32
+#undef VEC16_MADD
+
+#else
+
+inline void autoCorrelation16(int64_t *acf, int num_acf, const int16_t *signal, int num_signal)
+{
+    for (int k = 0; k < num_acf; k++)
+        acf[k] = dotProduct16(signal, &signal[k], num_signal - k);
+}
+
+#endif
+
+#endif  // __SIMD16__
@@ -0,0 +1,427 @@
+#ifndef __SIMD32__
+#define __SIMD32__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+#if ( __AVX2__ )
+#include <immintrin.h>
+#elif ( __SSE4_1__ )
+#include <smmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------
+// dot product of two int32 vectors with 64-bit accumulation
+//
+// Integer addition is associative, so all versions return exactly the same
+// result as the scalar loop. The SIMD versions multiply the even and the odd
+// 32-bit lanes separately with the signed 32x32->64 multiply (pmuldq).
+
+#if ( __AVX2__ )
+
+inline int64_t dotProduct32(const int32_t *a, const int32_t *b, int n)
+{
+    __m256i acc = _mm256_setzero_si256();
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *) &a[i]);
+        __m256i vb = _mm256_loadu_si256((const __m256i *) &b[i]);
+
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(va, vb));
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(_mm256_srli_epi64(va, 32),
+                                                     _mm256_srli_epi64(vb, 32)));
+    }
+
+    __m128i acc128 = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                   _mm256_extracti128_si256(acc, 1));
+    int64_t temp64 = _mm_cvtsi128_si64(acc128) + _mm_extract_epi64(acc128, 1);
+
+    for (; i < n; i++)
+        temp64 += (int64_t) a[i] * b[i];
+
+    return temp64;
+}
+
+#elif ( __SSE4_1__ )
+
+inline int64_t dotProduct32(const int32_t *a, const int32_t *b, int n)
+{
+    __m128i acc = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *) &a[i]);
+        __m128i vb = _mm_loadu_si128((const __m128i *) &b[i]);
+
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(va, vb));
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(_mm_srli_epi64(va, 32),
+                                               _mm_srli_epi64(vb, 32)));
+    }
+
+    int64_t temp64 = _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1);
+
+    for (; i < n; i++)
+        temp64 += (int64_t) a[i] * b[i];
+
+    return temp64;
+}
+
+#else
+
+inline int64_t dotProduct32(const int32_t *a, const int32_t *b, int n)
+{
+    int64_t temp64 = 0;
+
+    for (int i = 0; i < n; i++)
+        temp64 += (int64_t) a[i] * b[i];
+
+    return temp64;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// max(abs(x)) as in the scalar loop: labs() is truncated to int32, so
+// abs(INT32_MIN) is negative and never becomes the maximum
+
+#if ( __AVX2__ )
+
+inline int32_t maxAbs32(const int32_t *x, int n)
+{
+    __m256i max8 = _mm256_setzero_si256();
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+        max8 = _mm256_max_epi32(max8, _mm256_abs_epi32(_mm256_loadu_si256((const __m256i *) &x[i])));
+
+    __m128i max4 = _mm_max_epi32(_mm256_castsi256_si128(max8), _mm256_extracti128_si256(max8, 1));
+    max4 = _mm_max_epi32(max4, _mm_shuffle_epi32(max4, 0x4E));
+    max4 = _mm_max_epi32(max4, _mm_shuffle_epi32(max4, 0xB1));
+    int32_t max_value = _mm_cvtsi128_si32(max4);
+
+    for (; i < n; i++)
+    {
+        int32_t abs_value = (int32_t) labs(x[i]);
+        if (max_value < abs_value)
+            max_value = abs_value;
+    }
+
+    return max_value;
+}
+
+#elif ( __SSE4_1__ )
+
+inline int32_t maxAbs32(const int32_t *x, int n)
+{
+    __m128i max4 = _mm_setzero_si128();
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+        max4 = _mm_max_epi32(max4, _mm_abs_epi32(_mm_loadu_si128((const __m128i *) &x[i])));
+
+    max4 = _mm_max_epi32(max4, _mm_shuffle_epi32(max4, 0x4E));
+    max4 = _mm_max_epi32(max4, _mm_shuffle_epi32(max4, 0xB1));
+    int32_t max_value = _mm_cvtsi128_si32(max4);
+
+    for (; i < n; i++)
+    {
+        int32_t abs_value = (int32_t) labs(x[i]);
+        if (max_value < abs_value)
+            max_value = abs_value;
+    }
+
+    return max_value;
+}
+
+#else
+
+inline int32_t maxAbs32(const int32_t *x, int n)
+{
+    int32_t max_value = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        int32_t abs_value = (int32_t) labs(x[i]);
+        if (max_value < abs_value)
+            max_value = abs_value;
+    }
+
+    return max_value;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// in-place arithmetic shift, right for n_shift > 0, left for n_shift < 0
+
+#if ( __AVX2__ )
+
+inline void shift32(int32_t *x, int n, int n_shift)
+{
+    __m128i count = _mm_cvtsi32_si128(n_shift > 0 ? n_shift : -n_shift);
+    int i;
+
+    if (n_shift > 0)
+    {
+        for (i = 0; i + 8 <= n; i += 8)
+            _mm256_storeu_si256((__m256i *) &x[i], _mm256_sra_epi32(_mm256_loadu_si256((const __m256i *) &x[i]), count));
+        for (; i < n; i++)
+            x[i] = x[i] >> n_shift;
+    }
+    else
+    {
+        for (i = 0; i + 8 <= n; i += 8)
+            _mm256_storeu_si256((__m256i *) &x[i], _mm256_sll_epi32(_mm256_loadu_si256((const __m256i *) &x[i]), count));
+        for (; i < n; i++)
+            x[i] = x[i] << -n_shift;
+    }
+}
+
+#elif ( __SSE4_1__ )
+
+inline void shift32(int32_t *x, int n, int n_shift)
+{
+    __m128i count = _mm_cvtsi32_si128(n_shift > 0 ? n_shift : -n_shift);
+    int i;
+
+    if (n_shift > 0)
+    {
+        for (i = 0; i + 4 <= n; i += 4)
+            _mm_storeu_si128((__m128i *) &x[i], _mm_sra_epi32(_mm_loadu_si128((const __m128i *) &x[i]), count));
+        for (; i < n; i++)
+            x[i] = x[i] >> n_shift;
+    }
+    else
+    {
+        for (i = 0; i + 4 <= n; i += 4)
+            _mm_storeu_si128((__m128i *) &x[i], _mm_sll_epi32(_mm_loadu_si128((const __m128i *) &x[i]), count));
+        for (; i < n; i++)
+            x[i] = x[i] << -n_shift;
+    }
+}
+
+#else
+
+inline void shift32(int32_t *x, int n, int n_shift)
+{
+    if (n_shift > 0)
+    {
+        for (int i = 0; i < n; i++)
+            x[i] = x[i] >> n_shift;
+    }
+    else
+    {
+        for (int i = 0; i < n; i++)
+            x[i] = x[i] << -n_shift;
+    }
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// shift32() and the energy sum(x[i] * x[i]) of the shifted signal in one pass,
+// identical results for all versions
+
+#if ( __AVX2__ )
+
+inline int64_t shiftEnergy32(int32_t *x, int n, int n_shift)
+{
+    __m128i count = _mm_cvtsi32_si128(n_shift > 0 ? n_shift : -n_shift);
+    __m256i acc = _mm256_setzero_si256();
+    int64_t temp64;
+    int i;
+
+    for (i = 0; i + 8 <= n; i += 8)
+    {
+        __m256i v = _mm256_loadu_si256((const __m256i *) &x[i]);
+
+        v = (n_shift > 0) ? _mm256_sra_epi32(v, count) : _mm256_sll_epi32(v, count);
+        _mm256_storeu_si256((__m256i *) &x[i], v);
+
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(v, v));
+        v = _mm256_srli_epi64(v, 32);
+        acc = _mm256_add_epi64(acc, _mm256_mul_epi32(v, v));
+    }
+
+    __m128i acc128 = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                                   _mm256_extracti128_si256(acc, 1));
+    temp64 = _mm_cvtsi128_si64(acc128) + _mm_extract_epi64(acc128, 1);
+
+    for (; i < n; i++)
+    {
+        x[i] = (n_shift > 0) ? x[i] >> n_shift : x[i] << -n_shift;
+        temp64 += (int64_t) x[i] * x[i];
+    }
+
+    return temp64;
+}
+
+#elif ( __SSE4_1__ )
+
+inline int64_t shiftEnergy32(int32_t *x, int n, int n_shift)
+{
+    __m128i count = _mm_cvtsi32_si128(n_shift > 0 ? n_shift : -n_shift);
+    __m128i acc = _mm_setzero_si128();
+    int64_t temp64;
+    int i;
+
+    for (i = 0; i + 4 <= n; i += 4)
+    {
+        __m128i v = _mm_loadu_si128((const __m128i *) &x[i]);
+
+        v = (n_shift > 0) ? _mm_sra_epi32(v, count) : _mm_sll_epi32(v, count);
+        _mm_storeu_si128((__m128i *) &x[i], v);
+
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(v, v));
+        v = _mm_srli_epi64(v, 32);
+        acc = _mm_add_epi64(acc, _mm_mul_epi32(v, v));
+    }
+
+    temp64 = _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1);
+
+    for (; i < n; i++)
+    {
+        x[i] = (n_shift > 0) ? x[i] >> n_shift : x[i] << -n_shift;
+        temp64 += (int64_t) x[i] * x[i];
+    }
+
+    return temp64;
+}
+
+#else
+
+inline int64_t shiftEnergy32(int32_t *x, int n, int n_shift)
+{
+    int64_t temp64 = 0;
+
+    for (int i = 0; i < n; i++)
+    {
+        x[i] = (n_shift > 0) ? x[i] >> n_shift : x[i] << -n_shift;
+        temp64 += (int64_t) x[i] * x[i];
+    }
+
+    return temp64;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// autocorrelation acf[k] = sum(signal[i + k] * signal[i]) >> n_shift, k < num_acf
+//
+// Four lags are computed at a time so that each vector of signal[i] is loaded
+// once for all four. Identical results for all versions.
+
+
+#if ( __AVX2__ ) || ( __SSE4_1__ )
+
+#if ( __AVX2__ )
+
+#define VEC             __m256i
+#define VEC_LANES       8
+#define VEC_ZERO()      _mm256_setzero_si256()
+#define VEC_LOAD(p)     _mm256_loadu_si256((const __m256i *) (p))
+#define VEC_ADD64(a, b) _mm256_add_epi64(a, b)
+#define VEC_MUL32(a, b) _mm256_mul_epi32(a, b)
+#define VEC_ODD(a)      _mm256_srli_epi64(a, 32)
+
+inline int64_t sum64(__m256i acc)
+{
+    __m128i acc128 = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    return _mm_cvtsi128_si64(acc128) + _mm_extract_epi64(acc128, 1);
+}
+
+#else
+
+#define VEC             __m128i
+#define VEC_LANES       4
+#define VEC_ZERO()      _mm_setzero_si128()
+#define VEC_LOAD(p)     _mm_loadu_si128((const __m128i *) (p))
+#define VEC_ADD64(a, b) _mm_add_epi64(a, b)
+#define VEC_MUL32(a, b) _mm_mul_epi32(a, b)
+#define VEC_ODD(a)      _mm_srli_epi64(a, 32)
+
+inline int64_t sum64(__m128i acc)
+{
+    return _mm_cvtsi128_si64(acc) + _mm_extract_epi64(acc, 1);
+}
+
+#endif
+
+// x * y for the even and the odd 32-bit lanes, 64-bit accumulation
+#define VEC_MAC(acc, x, x_odd, y) \
+    acc = VEC_ADD64(VEC_ADD64(acc, VEC_MUL32(x, y)), VEC_MUL32(x_odd, VEC_ODD(y)))
+
+inline void autoCorrelation32(int32_t *acf, int num_acf, const int32_t *signal, int num_signal, int n_shift)
+{
+    int64_t sum[4];
+    int i, j, k, n;
+
+    // four lags at a time, each signal[i] vector is loaded once for all four
+    for (k = 0; k + 4 <= num_acf; k += 4)
+    {
+        VEC acc0 = VEC_ZERO(), acc1 = VEC_ZERO(), acc2 = VEC_ZERO(), acc3 = VEC_ZERO();
+
+        // common range of lags k..k+3
+        n = num_signal - k - 3;
+
+        for (i = 0; i + VEC_LANES <= n; i += VEC_LANES)
+        {
+            VEC x = VEC_LOAD(&signal[i]);
+            VEC x_odd = VEC_ODD(x);
+
+            VEC_MAC(acc0, x, x_odd, VEC_LOAD(&signal[i + k]));
+            VEC_MAC(acc1, x, x_odd, VEC_LOAD(&signal[i + k + 1]));
+            VEC_MAC(acc2, x, x_odd, VEC_LOAD(&signal[i + k + 2]));
+            VEC_MAC(acc3, x, x_odd, VEC_LOAD(&signal[i + k + 3]));
+        }
+
+        sum[0] = sum64(acc0);
+        sum[1] = sum64(acc1);
+        sum[2] = sum64(acc2);
+        sum[3] = sum64(acc3);
+
+        for (j = 0; j < 4; j++)
+        {
+            for (n = i; n < num_signal - k - j; n++)
+                sum[j] += ((int64_t) signal[n + k + j] * signal[n]);
+
+            acf[k + j] = (int32_t) (sum[j] >> n_shift);
+        }
+    }
+
+    for (; k < num_acf; k++)
+        acf[k] = (int32_t) (dotProduct32(signal, &signal[k], num_signal - k) >> n_shift);
+}
+
+#undef VEC
+#undef VEC_LANES
+#undef VEC_ZERO
+#undef VEC_LOAD
+#undef VEC_ADD64
+#undef VEC_MUL32
+#undef VEC_ODD
+#undef VEC_MAC
+
+#else
+
+inline void autoCorrelation32(int32_t *acf, int num_acf, const int32_t *signal, int num_signal, int n_shift)
+{
+    int64_t temp64;
+
+    for (int k = 0; k < num_acf; k++)
+    {
+        temp64 = 0;
+        for (int i = 0; i < num_signal - k; i++)
+        {
+            temp64 += ((int64_t) signal[i + k] * signal[i]);
+        }
+        acf[k] = (int32_t) (temp64 >> n_shift);
+    }
+}
+
+#endif
+
+#endif  // __SIMD32__
@@ -0,0 +1,192 @@
+#ifndef __SIMD_FLOAT__
+#define __SIMD_FLOAT__
+
+#if ( __AVX2__ )
+#include <immintrin.h>
+#elif ( __SSE4_1__ )
+#include <smmintrin.h>
+#endif
+
+//------------------------------------------------------------------------------
+// vector operations for float and double, overloaded on the element type so
+// that the kernels below are written once for both
+
+#if ( __AVX2__ )
+
+const int vec_float_bytes = 32;
+
+inline __m256  vecZero(const float *)  { return _mm256_setzero_ps(); }
+inline __m256d vecZero(const double *) { return _mm256_setzero_pd(); }
+
+inline __m256  vecLoad(const float *p)  { return _mm256_loadu_ps(p); }
+inline __m256d vecLoad(const double *p) { return _mm256_loadu_pd(p); }
+
+inline __m256  vecAdd(__m256 a, __m256 b)   { return _mm256_add_ps(a, b); }
+inline __m256d vecAdd(__m256d a, __m256d b) { return _mm256_add_pd(a, b); }
+
+#if ( __FMA__ )
+inline __m256  vecMulAdd(__m256 a, __m256 b, __m256 c)    { return _mm256_fmadd_ps(a, b, c); }
+inline __m256d vecMulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+inline __m256  vecMulAdd(__m256 a, __m256 b, __m256 c)    { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+inline __m256d vecMulAdd(__m256d a, __m256d b, __m256d c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+
+inline float vecSum(__m256 a)
+{
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(a), _mm256_extractf128_ps(a, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    return _mm_cvtss_f32(_mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1)));
+}
+
+inline double vecSum(__m256d a)
+{
+    __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(a), _mm256_extractf128_pd(a, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+}
+
+#elif ( __SSE4_1__ )
+
+const int vec_float_bytes = 16;
+
+inline __m128  vecZero(const float *)  { return _mm_setzero_ps(); }
+inline __m128d vecZero(const double *) { return _mm_setzero_pd(); }
+
+inline __m128  vecLoad(const float *p)  { return _mm_loadu_ps(p); }
+inline __m128d vecLoad(const double *p) { return _mm_loadu_pd(p); }
+
+inline __m128  vecAdd(__m128 a, __m128 b)   { return _mm_add_ps(a, b); }
+inline __m128d vecAdd(__m128d a, __m128d b) { return _mm_add_pd(a, b); }
+
+inline __m128  vecMulAdd(__m128 a, __m128 b, __m128 c)    { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+inline __m128d vecMulAdd(__m128d a, __m128d b, __m128d c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+
+inline float vecSum(__m128 a)
+{
+    a = _mm_add_ps(a, _mm_movehl_ps(a, a));
+    return _mm_cvtss_f32(_mm_add_ss(a, _mm_shuffle_ps(a, a, 1)));
+}
+
+inline double vecSum(__m128d a)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(a, _mm_unpackhi_pd(a, a)));
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// dot product of two float or double vectors
+//
+// The SIMD versions sum in a different order than the scalar loop, so the
+// results differ in the last bits between the versions. Two accumulators
+// hide the latency of the (fused) multiply-add.
+
+#if ( __AVX2__ ) || ( __SSE4_1__ )
+
+template <class T>
+inline T dotProductFloat(const T *a, const T *b, int n)
+{
+    const int lanes = vec_float_bytes / sizeof(T);
+    auto acc0 = vecZero(a);
+    auto acc1 = vecZero(a);
+    int i;
+
+    for (i = 0; i + 2 * lanes <= n; i += 2 * lanes)
+    {
+        acc0 = vecMulAdd(vecLoad(&a[i]), vecLoad(&b[i]), acc0);
+        acc1 = vecMulAdd(vecLoad(&a[i + lanes]), vecLoad(&b[i + lanes]), acc1);
+    }
+    for (; i + lanes <= n; i += lanes)
+        acc0 = vecMulAdd(vecLoad(&a[i]), vecLoad(&b[i]), acc0);
+
+    T sum = vecSum(vecAdd(acc0, acc1));
+
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+
+    return sum;
+}
+
+#else
+
+template <class T>
+inline T dotProductFloat(const T *a, const T *b, int n)
+{
+    T sum0 = 0, sum1 = 0;
+    int i;
+
+    for (i = 0; i + 2 <= n; i += 2)
+    {
+        sum0 += a[i] * b[i];
+        sum1 += a[i + 1] * b[i + 1];
+    }
+    if (i < n)
+        sum0 += a[i] * b[i];
+
+    return sum0 + sum1;
+}
+
+#endif
+
+//------------------------------------------------------------------------------
+// autocorrelation acf[k] = sum(signal[i + k] * signal[i]), k < num_acf
+//
+// Four lags are computed at a time so that each vector of signal[i] is loaded
+// once for all four, as in autoCorrelation32.
+
+#if ( __AVX2__ ) || ( __SSE4_1__ )
+
+template <class T>
+inline void autoCorrelationFloat(T *acf, int num_acf, const T *signal, int num_signal)
+{
+    const int lanes = vec_float_bytes / sizeof(T);
+    int i, j, k;
+
+    for (k = 0; k + 4 <= num_acf; k += 4)
+    {
+        const T *s = &signal[k];
+        auto acc0 = vecZero(signal);
+        auto acc1 = vecZero(signal);
+        auto acc2 = vecZero(signal);
+        auto acc3 = vecZero(signal);
+
+        // samples for which all four lags are defined
+        int n = num_signal - k - 3;
+
+        for (i = 0; i + lanes <= n; i += lanes)
+        {
+            auto x = vecLoad(&signal[i]);
+
+            acc0 = vecMulAdd(x, vecLoad(&s[i]), acc0);
+            acc1 = vecMulAdd(x, vecLoad(&s[i + 1]), acc1);
+            acc2 = vecMulAdd(x, vecLoad(&s[i + 2]), acc2);
+            acc3 = vecMulAdd(x, vecLoad(&s[i + 3]), acc3);
+        }
+
+        acf[k] = vecSum(acc0);
+        acf[k + 1] = vecSum(acc1);
+        acf[k + 2] = vecSum(acc2);
+        acf[k + 3] = vecSum(acc3);
+
+        // remaining samples of each lag
+        for (j = 0; j < 4; j++)
+            for (int m = i; m < num_signal - k - j; m++)
+                acf[k + j] += signal[m] * s[m + j];
+    }
+
+    for (; k < num_acf; k++)
+        acf[k] = dotProductFloat(signal, &signal[k], num_signal - k);
+}
+
+#else
+
+template <class T>
+inline void autoCorrelationFloat(T *acf, int num_acf, const T *signal, int num_signal)
+{
+    for (int k = 0; k < num_acf; k++)
+        acf[k] = dotProductFloat(signal, &signal[k], num_signal - k);
+}
+
+#endif
+
+#endif  // __SIMD_FLOAT__
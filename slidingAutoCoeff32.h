@@ -0,0 +1,127 @@
+#ifndef _SLIDING_ACF32
+#define _SLIDING_ACF32
+
+#include <stdint.h>
+#include <string.h>
+
+#include "simd32.h"
+
+/*---------------------------------------------------------------------------*\
+|   Sliding autocorrelation over the last window_length samples               |
+|                                                                             |
+|   The lag sums are updated with the products that enter and the products    |
+|   that leave the window, O(num_acf) per sample independent of the window    |
+|   length. The sums are exact in 64 bits, so they never drift and            |
+|   need no renormalization; the input is scaled down once so that            |
+|   window_length products of two samples cannot overflow.                    |
+|                                                                             |
+|   The result is the autocorrelation method with a rectangular window,       |
+|   normalized as calcAutoCoeff32 (acf[0] = 1 in 1.31 format).                |
+\*---------------------------------------------------------------------------*/
+
+template <int num_acf, int window_length>
+class SlidingAutoCoeff32
+{
+    static_assert((window_length & (window_length - 1)) == 0, "window_length must be a power of two");
+    static_assert(num_acf <= window_length, "more lags than samples in the window");
+
+    // history[end - window_length .. end - 1] is the window, new samples are
+    // appended at end, the window is moved back to the start when full
+    static const int history_length = 2 * window_length;
+
+    int32_t history[history_length];
+    int64_t sum[num_acf];
+    int end;
+    int n_shift;
+
+public:
+    SlidingAutoCoeff32(void)
+    {
+        // |x| < 2^(31 - n_shift), window_length * x^2 < 2^62
+        int log2_length = 0;
+        for (int i = 1; i < window_length; i *= 2)
+            log2_length++;
+        n_shift = (log2_length + 1) / 2 + 1;
+
+        reset();
+    }
+
+    void reset(void)
+    {
+        for (int i = 0; i < history_length; i++)
+            history[i] = 0;
+
+        for (int k = 0; k < num_acf; k++)
+            sum[k] = 0;
+
+        end = window_length;
+    }
+
+    void push(const int32_t *signal, int num_signal)
+    {
+        while (num_signal > 0)
+        {
+            int n = num_signal < window_length ? num_signal : window_length;
+
+            if (end + n > history_length)
+            {
+                memmove(history, &history[end - window_length], window_length * sizeof(int32_t));
+                end = window_length;
+            }
+
+            int32_t *x_new = &history[end];
+            const int32_t *x_old = x_new - window_length;
+
+            for (int i = 0; i < n; i++)
+                x_new[i] = signal[i] >> n_shift;
+
+            // x[i] * x[i - k] enter, x[i - window_length] * x[i - window_length + k] leave,
+            // summed over the n new samples i, exact in any order
+            for (int k = 0; k < num_acf; k++)
+                sum[k] += dotProduct32(x_new, x_new - k, n) - dotProduct32(x_old, x_old + k, n);
+
+            end += n;
+            signal += n;
+            num_signal -= n;
+        }
+    }
+
+    void get(int32_t *acf)
+    {
+        int i, k;
+        int64_t temp64;
+
+        if (sum[0] == 0)
+        {
+            acf[0] = 0x7FFFFFFF;
+            for (k = 1; k < num_acf; k++)
+                acf[k] = 0;
+            return;
+        }
+
+        // sum[0] << n_norm in [2^62, 2^63), |sum[k]| <= sum[0]
+        int n_norm = 0;
+        while ((sum[0] << n_norm) < (1LL << 62))
+            n_norm++;
+
+        // 1/acf[0] in 4.28 format as in calcAutoCoeff32
+        int32_t acf0 = (int32_t) ((sum[0] << n_norm) >> 32);
+        int32_t inv_acf0 = (int32_t) ((1LL << 59) / acf0);
+
+        const int64_t max_acf = (1ll << 59)-1;
+
+        for (k = 0; k < num_acf; k++)
+        {
+            i = (int32_t) ((int64_t) ((uint64_t) sum[k] << n_norm) >> 32);
+
+            temp64 = ((int64_t) i * inv_acf0);
+
+            if (temp64 > max_acf)
+                temp64 = max_acf;
+
+            acf[k] = (int32_t) (temp64 >> 28);
+        }
+    }
+};
+
+#endif  // _SLIDING_ACF32
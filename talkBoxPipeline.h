@@ -0,0 +1,247 @@
+#ifndef _TALK_BOX_PIPELINE
+#define _TALK_BOX_PIPELINE
+
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "cacheLine.h"
+#include "blockRing.h"
+#include "tripleBuffer.h"
+#include "analysisTask.h"
+
+/*---------------------------------------------------------------------------*\
+|   Voice Input, Frame Handoff and Analysis Thread of a TalkBox               |
+|                                                                             |
+|   Common to TalkBox (fixed point) and TalkBoxFloat. The audio thread cuts   |
+|   the voice into hops of hop_size samples and hands them to the analysis    |
+|   through a BlockRing, the analysis of one hop (analyzeBlock() of the       |
+|   engine) publishes a Frame through a TripleBuffer. The analysis runs       |
+|   inline in calculateLPCcoefficients(), on its own thread, or from an       |
+|   AnalysisScheduler.                                                        |
+|                                                                             |
+|   The engines call stopAnalysisThread() in their destructor, before their   |
+|   analyzeBlock() is gone.                                                   |
+\*---------------------------------------------------------------------------*/
+
+// gate with hysteresis, opens at level and closes below half of it
+template <class T>
+struct NoiseGate
+{
+    T level;
+    bool closed;
+
+    // level of the current hop, true if the gate opens again
+    bool update(T rms)
+    {
+        if (closed)
+        {
+            closed = rms < level;
+            return closed == false;
+        }
+
+        closed = rms < level / 2;
+        return false;
+    }
+};
+
+template <class Sample, class Frame>
+class TalkBoxPipeline : public AnalysisTask
+{
+protected:
+    // configuration, written by the setters before processing starts,
+    // read by both threads
+    double fs;
+    int num_blocks;
+    int hop_size;
+
+    // audio thread
+    alignas(cache_line_size) int buffer_position;
+    Sample *sample_buffer;
+
+    // handoff between the threads, BlockRing and TripleBuffer keep the
+    // producer and the consumer side in separate cache lines
+    BlockRing<Sample> input_blocks;
+    TripleBuffer<Frame> lpc_frames;
+    alignas(cache_line_size) std::atomic<uint32_t> overrun_count;
+    std::atomic<bool> analysis_running;
+    std::thread analysis_thread;
+
+    // analyzes the oldest complete hop and publishes its frame, false if
+    // there is none
+    virtual bool analyzeBlock(void) = 0;
+
+    // ring of input blocks, num_blocks - 1 blocks of slack for the analysis
+    TalkBoxPipeline(double fs, int num_blocks)
+    {
+        this->fs = fs;
+        this->num_blocks = num_blocks;
+        hop_size = 0;
+        buffer_position = 0;
+        sample_buffer = 0;
+        overrun_count = 0;
+        analysis_running = false;
+    }
+
+    // power of two, 1..block_length, returns its base 2 logarithm; not
+    // thread safe, the engine resets its states afterwards
+    int setHop(int hop, int block_length)
+    {
+        int n_shift = 0;
+
+        if (hop > block_length)
+            hop = block_length;
+
+        hop_size = 1;
+        while (hop_size * 2 <= hop)
+        {
+            hop_size *= 2;
+            n_shift++;
+        }
+
+        // same amount of slack in samples for every hop size
+        input_blocks.resize(num_blocks * (block_length / hop_size), hop_size);
+
+        return n_shift;
+    }
+
+    // empty ring, not thread safe
+    void resetInput(void)
+    {
+        buffer_position = 0;
+        input_blocks.reset();
+        sample_buffer = input_blocks.writeBlock();
+    }
+
+    void pushBlock(void)
+    {
+        buffer_position = 0;
+
+        // hand the block to the analysis, overwrite it if the ring is full
+        if (input_blocks.push() == false)
+            overrun_count.fetch_add(1, std::memory_order_relaxed);
+
+        sample_buffer = input_blocks.writeBlock();
+    }
+
+    void analysisLoop(void)
+    {
+        // the audio thread only publishes blocks through the ring, the worker
+        // polls it a few times per block period instead of being signalled
+        std::chrono::microseconds poll_interval((long) (250000. * hop_size / fs));
+
+        while (analysis_running)
+        {
+            while (analyzeBlock())
+                ;
+
+            std::this_thread::sleep_for(poll_interval);
+        }
+    }
+
+public:
+    ~TalkBoxPipeline(void)
+    {
+        stopAnalysisThread();
+    }
+
+    void pushVoice(const Sample *voice, int num_samples, int stride = 1)
+    {
+        int n;
+
+        // voice signal, copied in chunks that end at hop boundaries
+        for (int i = 0; i < num_samples; i += n)
+        {
+            n = hop_size - buffer_position;
+            if (n > num_samples - i)
+                n = num_samples - i;
+
+            // no voice in playback, the blocks only count the samples
+            if (voice && stride == 1)
+                memcpy(&sample_buffer[buffer_position], &voice[i], n * sizeof(Sample));
+            else if (voice)
+                for (int j = 0; j < n; j++)
+                    sample_buffer[buffer_position + j] = voice[(i + j) * stride];
+
+            buffer_position += n;
+
+            if (buffer_position >= hop_size)
+                pushBlock();
+        }
+    }
+
+    // latest coefficient set, never blocks, for the audio thread
+    const Frame *getFrame(void)
+    {
+        return lpc_frames.readBuffer();
+    }
+
+    void calculateLPCcoefficients(void)
+    {
+        // the analysis thread is the only consumer while it is running
+        if (analysis_running)
+            return;
+
+        while (analyzeBlock())
+            ;
+    }
+
+    bool analyzeNextBlock(void) override
+    {
+        // one block for the AnalysisScheduler, same rule as above
+        if (analysis_running)
+            return false;
+
+        return analyzeBlock();
+    }
+
+    int getReadyBlocks(void) override
+    {
+        return input_blocks.getNumComplete();
+    }
+
+    double getSlack(void) override
+    {
+        // hops until a completed block finds the ring full
+        int free_blocks = input_blocks.getNumBlocks() - 1 - input_blocks.getNumComplete();
+
+        return free_blocks * hop_size / fs;
+    }
+
+    void startAnalysisThread(void)
+    {
+        if (analysis_running)
+            return;
+
+        analysis_running = true;
+        analysis_thread = std::thread(&TalkBoxPipeline::analysisLoop, this);
+    }
+
+    void stopAnalysisThread(void)
+    {
+        if (analysis_running == false)
+            return;
+
+        analysis_running = false;
+        analysis_thread.join();
+    }
+
+    int getHopSize(void)
+    {
+        return hop_size;
+    }
+
+    // samples of the current hop pushed so far, for the audio thread
+    int getHopPosition(void)
+    {
+        return buffer_position;
+    }
+
+    uint32_t getOverrunCount(void)
+    {
+        return overrun_count.load(std::memory_order_relaxed);
+    }
+};
+
+#endif  // _TALK_BOX_PIPELINE
@@ -0,0 +1,681 @@
+/*---------------------------------------------------------------------------*\
+|   talkboxRender: offline rendering with TalkBox32                           |
+|                                                                             |
+|   g++ -std=c++17 -O2 -march=native -o talkboxRender talkboxRender.cpp       |
+|       TalkBox32.cpp calcAutoCoeff32.cpp fftAutoCoeff32.cpp durbin32.cpp     |
+|       lpcFilter32.cpp lpcFrameFile32.cpp -lpthread                          |
+|                                                                             |
+|   talkboxRender [options] stereo.wav out.wav                                |
+|       left channel carrier, right channel voice (as process() expects)      |
+|   talkboxRender [options] carrier.wav voice.wav out.wav                     |
+|   talkboxRender --raw [options] < stereo.pcm > out.pcm                      |
+|       interleaved carrier/voice, little endian, mono output                 |
+|   talkboxRender --play take.lpc [options] carrier.wav out.wav               |
+|       frames of a --record run instead of the analysis of a voice           |
+|                                                                             |
+|   options:                                                                  |
+|       --bits 16|32    raw sample format, wav output format (default: input) |
+|       --fs rate       raw sample rate (default 48000)                       |
+|       --hop n         analysis hop size, see TalkBox::setHopSize()          |
+|       --lattice       lattice synthesis filter                              |
+|       --interpolate   interpolation between frames                          |
+|       --record file   writes the analysis frames to file                    |
+|       --play file     replays the frames of file, same --hop as recorded    |
+|       --threads n     renders n segments of a wav file in parallel          |
+|       --warmup n      blocks rendered before each segment (default 128)     |
+|                                                                             |
+|   The input files are memory mapped, the output file as well, 32-bit mono   |
+|   signals are processed in place without copies. The analysis runs          |
+|   inline after every block. Throughput is reported on stderr.               |
+|                                                                             |
+|   With --threads every segment has its own TalkBox32, which starts --warmup |
+|   blocks of render_block samples before the segment from reset states and   |
+|   discards that output. The segments start on the block and hop grid of the |
+|   sequential render, so the frames fall on the same samples; the analysis   |
+|   and filter states converge within the warm-up, see README.md for the      |
+|   measured deviation. Not with --record or --play.                          |
+\*---------------------------------------------------------------------------*/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "TalkBox32.h"
+#include "lpcFrameFile32.h"
+
+const int render_block = 1024;      // samples per processBlock() call
+const int render_warmup = 128;      // blocks before a segment with --threads
+
+// memory mapped PCM wav file (16 or 32 bit integer)
+struct WavFile
+{
+    uint8_t *map;
+    size_t map_size;
+    const uint8_t *data;
+    int num_channels;
+    int bits;
+    int fs;
+    long num_frames;
+};
+
+static uint32_t readLE32(const uint8_t *p)
+{
+    return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t) p[3] << 24);
+}
+
+static uint16_t readLE16(const uint8_t *p)
+{
+    return (uint16_t) (p[0] | (p[1] << 8));
+}
+
+static void writeLE32(uint8_t *p, uint32_t x)
+{
+    p[0] = x; p[1] = x >> 8; p[2] = x >> 16; p[3] = x >> 24;
+}
+
+static void writeLE16(uint8_t *p, uint16_t x)
+{
+    p[0] = x; p[1] = x >> 8;
+}
+
+static void closeWav(WavFile *wav)
+{
+    if (wav->map)
+        munmap(wav->map, wav->map_size);
+
+    wav->map = 0;
+}
+
+static bool openWav(const char *name, WavFile *wav)
+{
+    struct stat st;
+    int fd = open(name, O_RDONLY);
+
+    wav->map = 0;
+
+    if (fd < 0 || fstat(fd, &st) != 0 || st.st_size < 12)
+    {
+        fprintf(stderr, "%s: cannot open\n", name);
+        if (fd >= 0)
+            close(fd);
+        return false;
+    }
+
+    wav->map_size = st.st_size;
+    uint8_t *map = (uint8_t *) mmap(0, wav->map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (map == MAP_FAILED)
+    {
+        fprintf(stderr, "%s: cannot map\n", name);
+        return false;
+    }
+    wav->map = map;
+    madvise(wav->map, wav->map_size, MADV_SEQUENTIAL);
+
+    const uint8_t *p = wav->map;
+    const uint8_t *end = wav->map + wav->map_size;
+    const char *error = 0;
+    uint32_t data_size = 0;
+
+    wav->data = 0;
+    wav->num_channels = 0;
+    wav->bits = 0;
+    wav->fs = 0;
+    wav->num_frames = 0;
+
+    if (memcmp(p, "RIFF", 4) != 0 || memcmp(p + 8, "WAVE", 4) != 0)
+        error = "not a wav file";
+
+    // chunks
+    for (p += 12; error == 0 && p + 8 <= end; )
+    {
+        uint32_t size = readLE32(p + 4);
+        const uint8_t *chunk = p + 8;
+
+        if (size > (size_t) (end - chunk))
+            size = end - chunk;
+
+        if (memcmp(p, "fmt ", 4) == 0 && size >= 16)
+        {
+            int format = readLE16(chunk);
+
+            // PCM or WAVE_FORMAT_EXTENSIBLE with PCM subformat
+            if (format == 0xFFFE && size >= 26)
+                format = readLE16(chunk + 24);
+
+            wav->num_channels = readLE16(chunk + 2);
+            wav->fs = readLE32(chunk + 4);
+            wav->bits = readLE16(chunk + 14);
+
+            if (format != 1)
+                error = "only integer PCM is supported";
+        }
+        else if (memcmp(p, "data", 4) == 0)
+        {
+            wav->data = chunk;
+            data_size = size;
+            break;
+        }
+
+        p = chunk + size + (size & 1);
+    }
+
+    // the frame size divides the data size, so the format is checked first
+    if (error == 0 && (wav->data == 0 || (wav->bits != 16 && wav->bits != 32) ||
+                       wav->num_channels < 1 || wav->fs < 1))
+        error = "16 or 32 bit PCM with fmt and data chunks expected";
+
+    if (error)
+    {
+        fprintf(stderr, "%s: %s\n", name, error);
+        closeWav(wav);
+        return false;
+    }
+
+    wav->num_frames = data_size / (wav->num_channels * wav->bits / 8);
+
+    return true;
+}
+
+// one channel of frames [start, start + n) as 32-bit samples
+static void readChannel(const WavFile *wav, int channel, long start, int n, int32_t *out)
+{
+    if (wav->bits == 16)
+    {
+        const uint8_t *p = wav->data + (start * wav->num_channels + channel) * 2;
+        for (int i = 0; i < n; i++, p += 2 * wav->num_channels)
+            out[i] = (int32_t) ((uint32_t) readLE16(p) << 16);
+    }
+    else
+    {
+        const uint8_t *p = wav->data + (start * wav->num_channels + channel) * 4;
+        for (int i = 0; i < n; i++, p += 4 * wav->num_channels)
+            out[i] = (int32_t) readLE32(p);
+    }
+}
+
+// 32-bit mono data can be handed to processBlock() without a copy
+static const int32_t *directChannel(const WavFile *wav, long start)
+{
+    if (wav->bits != 32 || wav->num_channels != 1 || ((uintptr_t) wav->data & 3) != 0)
+        return 0;
+
+    return (const int32_t *) wav->data + start;
+}
+
+static double seconds(std::chrono::steady_clock::time_point t0)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+}
+
+static void reportThroughput(long num_frames, double fs, double elapsed)
+{
+    fprintf(stderr, "%ld samples in %.3f s, %.2f Msamples/s, %.1f x real time\n",
+            num_frames, elapsed, num_frames / elapsed * 1e-6, num_frames / fs / elapsed);
+}
+
+struct Options
+{
+    int bits;
+    double fs;
+    int hop;
+    bool lattice;
+    bool interpolate;
+    const char *record;
+    const char *play;
+    int threads;
+    int warmup;
+};
+
+// recorder and player are the files of --record and --play, they have to
+// outlive the processing of talkbox, which runs at fs
+static bool configure(TalkBox32 &talkbox, double fs, const Options &options, LPCFrameWriter32 *recorder, LPCFrameReader32 *player)
+{
+    if (options.hop > 0)
+        talkbox.setHopSize(options.hop);
+    talkbox.setLatticeFilter(options.lattice);
+    talkbox.setInterpolation(options.interpolate);
+
+    if (options.record)
+    {
+        if (!recorder->open(options.record, TalkBox32::num_coeffs, talkbox.getHopSize(),
+                            TalkBox32::block_length, fractional_digits, fs))
+        {
+            fprintf(stderr, "%s: cannot create\n", options.record);
+            return false;
+        }
+        talkbox.startRecording(recorder);
+    }
+    if (options.play && (!player->open(options.play) || !talkbox.startPlayback(player)))
+    {
+        fprintf(stderr, "%s: no frame file of this order and hop size\n", options.play);
+        return false;
+    }
+
+    return true;
+}
+
+// input and output of renderWav(), shared by the segment threads
+struct RenderJob
+{
+    const WavFile *carrier;
+    const WavFile *voice;
+    int voice_channel;
+    bool voice_file;            // separate voice file, 32-bit mono used in place
+    bool play;
+    int bits;
+    int32_t *out32;
+    int16_t *out16;
+};
+
+// renders the frames [start, end) with talkbox, which runs from warm_start
+// on and discards the output before start; warm_start and start are
+// multiples of render_block
+static void renderRange(TalkBox32 *talkbox, const RenderJob &job, long warm_start, long start, long end)
+{
+    int32_t carrier_block[render_block], voice_block[render_block], out_block[render_block];
+
+    for (long pos = warm_start; pos < end; pos += render_block)
+    {
+        int n = (int) ((end - pos < render_block) ? end - pos : render_block);
+
+        const int32_t *c = directChannel(job.carrier, pos);
+        const int32_t *v = job.voice_file ? directChannel(job.voice, pos) : 0;
+
+        if (c == 0)
+        {
+            readChannel(job.carrier, 0, pos, n, carrier_block);
+            c = carrier_block;
+        }
+        if (job.play)
+            v = 0;
+        else if (v == 0)
+        {
+            readChannel(job.voice, job.voice_channel, pos, n, voice_block);
+            v = voice_block;
+        }
+
+        if (job.bits == 32 && pos >= start)
+        {
+            talkbox->processBlock(c, v, &job.out32[pos], n);
+        }
+        else
+        {
+            talkbox->processBlock(c, v, out_block, n);
+            if (pos >= start)
+                for (int i = 0; i < n; i++)
+                    job.out16[pos + i] = (int16_t) (out_block[i] >> 16);
+        }
+
+        talkbox->calculateLPCcoefficients();
+    }
+}
+
+static int renderWav(const char *carrier_name, const char *voice_name, const char *out_name, const Options &options)
+{
+    WavFile carrier, voice;
+    int voice_channel = 0;
+
+    if (!openWav(carrier_name, &carrier))
+        return 1;
+
+    if (options.play)
+    {
+        voice = carrier;    // not read
+    }
+    else if (voice_name)
+    {
+        if (!openWav(voice_name, &voice))
+        {
+            closeWav(&carrier);
+            return 1;
+        }
+        if (voice.fs != carrier.fs)
+        {
+            fprintf(stderr, "sample rates differ\n");
+            closeWav(&voice);
+            closeWav(&carrier);
+            return 1;
+        }
+    }
+    else
+    {
+        if (carrier.num_channels < 2)
+        {
+            fprintf(stderr, "%s: stereo file expected\n", carrier_name);
+            closeWav(&carrier);
+            return 1;
+        }
+        voice = carrier;
+        voice_channel = 1;
+    }
+
+    long num_frames = carrier.num_frames < voice.num_frames ? carrier.num_frames : voice.num_frames;
+    int bits = options.bits ? options.bits : carrier.bits;
+    size_t data_size = (size_t) num_frames * (bits / 8);
+    size_t out_size = 44 + data_size;
+
+    // output file, mapped and written in place
+    int fd = open(out_name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    uint8_t *out_map = (uint8_t *) MAP_FAILED;
+
+    if (fd < 0 || ftruncate(fd, out_size) != 0)
+        fprintf(stderr, "%s: cannot create\n", out_name);
+    else if ((out_map = (uint8_t *) mmap(0, out_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED)
+        fprintf(stderr, "%s: cannot map\n", out_name);
+
+    if (fd >= 0)
+        close(fd);
+
+    if (out_map == MAP_FAILED)
+    {
+        if (voice_name && !options.play)
+            closeWav(&voice);
+        closeWav(&carrier);
+        return 1;
+    }
+
+    // mono PCM header
+    memcpy(out_map, "RIFF", 4);
+    writeLE32(out_map + 4, (uint32_t) (36 + data_size));
+    memcpy(out_map + 8, "WAVEfmt ", 8);
+    writeLE32(out_map + 16, 16);
+    writeLE16(out_map + 20, 1);
+    writeLE16(out_map + 22, 1);
+    writeLE32(out_map + 24, carrier.fs);
+    writeLE32(out_map + 28, carrier.fs * (bits / 8));
+    writeLE16(out_map + 32, bits / 8);
+    writeLE16(out_map + 34, bits);
+    memcpy(out_map + 36, "data", 4);
+    writeLE32(out_map + 40, (uint32_t) data_size);
+
+    RenderJob job = { &carrier, &voice, voice_channel, voice_name != 0, options.play != 0, bits,
+                      (int32_t *) (out_map + 44), (int16_t *) (out_map + 44) };
+
+    // one TalkBox32 per segment, --record and --play only with one
+    int num_segments = (options.threads > 1) ? options.threads : 1;
+    std::vector<TalkBox32 *> talkboxes;
+    LPCFrameWriter32 recorder;
+    LPCFrameReader32 player;
+    bool configured = true;
+
+    for (int k = 0; k < num_segments && configured; k++)
+    {
+        talkboxes.push_back(new TalkBox32(carrier.fs));
+        configured = configure(*talkboxes[k], carrier.fs, options, &recorder, &player);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    if (configured && num_segments == 1)
+    {
+        renderRange(talkboxes[0], job, 0, 0, num_frames);
+    }
+    else if (configured)
+    {
+        // segments and warm-up on the common grid of the blocks and the hop
+        long grid = render_block;
+        while (grid % talkboxes[0]->getHopSize() != 0)
+            grid += render_block;
+
+        long segment = (num_frames / num_segments + grid - 1) / grid * grid;
+        std::vector<std::thread> threads;
+
+        for (int k = 0; k < num_segments && k * segment < num_frames; k++)
+        {
+            long start = k * segment;
+            long end = (start + segment < num_frames) ? start + segment : num_frames;
+            long warm_start = (start - (long) options.warmup * render_block) / grid * grid;
+
+            if (warm_start < 0)
+                warm_start = 0;
+
+            threads.push_back(std::thread(renderRange, talkboxes[k], std::cref(job), warm_start, start, end));
+        }
+
+        for (auto &thread : threads)
+            thread.join();
+    }
+
+    double elapsed = seconds(t0);
+
+    // the header of the frame file is completed by close()
+    bool recorded = true;
+
+    if (options.record && configured)
+    {
+        bool written = talkboxes[0]->stopRecording();
+
+        if (recorder.close() == false || written == false)
+        {
+            fprintf(stderr, "%s: write error\n", options.record);
+            recorded = false;
+        }
+    }
+
+    munmap(out_map, out_size);
+    if (voice_name && !options.play)
+        closeWav(&voice);
+    closeWav(&carrier);
+    for (TalkBox32 *talkbox : talkboxes)
+        delete talkbox;
+
+    if (configured == false || recorded == false)
+        return 1;
+
+    reportThroughput(num_frames, carrier.fs, elapsed);
+
+    return 0;
+}
+
+// reads exactly size bytes unless the stream ends
+static size_t readAll(int fd, void *buffer, size_t size)
+{
+    size_t done = 0;
+
+    while (done < size)
+    {
+        ssize_t n = read(fd, (uint8_t *) buffer + done, size - done);
+        if (n <= 0)
+            break;
+        done += n;
+    }
+
+    return done;
+}
+
+static bool writeAll(int fd, const void *buffer, size_t size)
+{
+    size_t done = 0;
+
+    while (done < size)
+    {
+        ssize_t n = write(fd, (const uint8_t *) buffer + done, size - done);
+        if (n <= 0)
+            return false;
+        done += n;
+    }
+
+    return true;
+}
+
+static int renderRaw(const Options &options)
+{
+    int bits = options.bits ? options.bits : 32;
+    int bytes = bits / 8;
+    long num_frames = 0;
+
+    uint8_t in_bytes[2 * render_block * 4];
+    int32_t samples[2 * render_block];
+    uint8_t out_bytes[render_block * 4];
+    bool written = true;
+
+    LPCFrameWriter32 recorder;
+    LPCFrameReader32 player;
+
+    TalkBox32 *talkbox = new TalkBox32(options.fs);
+    if (!configure(*talkbox, options.fs, options, &recorder, &player))
+    {
+        delete talkbox;
+        return 1;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (;;)
+    {
+        int n = (int) (readAll(0, in_bytes, 2 * render_block * bytes) / (2 * bytes));
+        if (n == 0)
+            break;
+
+        for (int i = 0; i < 2 * n; i++)
+            samples[i] = (bits == 16) ? (int32_t) ((uint32_t) readLE16(&in_bytes[2 * i]) << 16)
+                                      : (int32_t) readLE32(&in_bytes[4 * i]);
+
+        // carrier in the even samples is replaced by the output
+        talkbox->processBlock(samples, n);
+        talkbox->calculateLPCcoefficients();
+
+        for (int i = 0; i < n; i++)
+        {
+            if (bits == 16)
+                writeLE16(&out_bytes[2 * i], (uint16_t) (samples[2 * i] >> 16));
+            else
+                writeLE32(&out_bytes[4 * i], (uint32_t) samples[2 * i]);
+        }
+
+        if (!writeAll(1, out_bytes, n * bytes))
+        {
+            fprintf(stderr, "write error\n");
+            written = false;
+            break;
+        }
+
+        num_frames += n;
+    }
+
+    double elapsed = seconds(t0);
+
+    bool recorded = true;
+
+    if (options.record)
+    {
+        bool written = talkbox->stopRecording();
+
+        if (recorder.close() == false || written == false)
+        {
+            fprintf(stderr, "%s: write error\n", options.record);
+            recorded = false;
+        }
+    }
+
+    delete talkbox;
+
+    if (written == false || recorded == false)
+        return 1;
+
+    reportThroughput(num_frames, options.fs, elapsed);
+
+    return 0;
+}
+
+static int usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [options] stereo.wav out.wav\n"
+            "       %s [options] carrier.wav voice.wav out.wav\n"
+            "       %s --raw [options] < stereo.pcm > out.pcm\n"
+            "       %s --play take.lpc [options] carrier.wav out.wav\n"
+            "options: --bits 16|32  --fs rate  --hop n  --lattice  --interpolate\n"
+            "         --record file  --play file  --threads n  --warmup n\n",
+            name, name, name, name);
+    return 1;
+}
+
+int main(int argc, char *argv[])
+{
+    Options options = { 0, 48000, 0, false, false, 0, 0, 1, render_warmup };
+    bool raw = false;
+    const char *files[3];
+    int num_files = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--raw") == 0)
+            raw = true;
+        else if (strcmp(argv[i], "--bits") == 0 && i + 1 < argc)
+            options.bits = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--fs") == 0 && i + 1 < argc)
+            options.fs = atof(argv[++i]);
+        else if (strcmp(argv[i], "--hop") == 0 && i + 1 < argc)
+            options.hop = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--lattice") == 0)
+            options.lattice = true;
+        else if (strcmp(argv[i], "--interpolate") == 0)
+            options.interpolate = true;
+        else if (strcmp(argv[i], "--record") == 0 && i + 1 < argc)
+            options.record = argv[++i];
+        else if (strcmp(argv[i], "--play") == 0 && i + 1 < argc)
+            options.play = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            options.threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc)
+            options.warmup = atoi(argv[++i]);
+        else if (argv[i][0] != '-' && num_files < 3)
+            files[num_files++] = argv[i];
+        else
+            return usage(argv[0]);
+    }
+
+    if (options.bits != 0 && options.bits != 16 && options.bits != 32)
+        return usage(argv[0]);
+
+    // the segments would write and read the frame file out of order
+    if (options.threads > 1 && (raw || options.record || options.play || options.warmup < 0))
+        return usage(argv[0]);
+
+    if (raw)
+        return (num_files == 0) ? renderRaw(options) : usage(argv[0]);
+
+    if (num_files == 2)
+        return renderWav(files[0], 0, files[1], options);
+    if (num_files == 3)
+        return renderWav(files[0], files[1], files[2], options);
+
+    return usage(argv[0]);
+}
+
+//--------------------- License ------------------------------------------------
+
+// Copyright (c) 2016 Finn Bayer, Christoph Eike, Uwe Simmer
+
+// Permission is hereby granted, free of charge, to any person obtaining 
+// a copy of this software and associated documentation files 
+// (the "Software"), to deal in the Software without restriction, 
+// including without limitation the rights to use, copy, modify, merge, 
+// publish, distribute, sublicense, and/or sell copies of the Software, 
+// and to permit persons to whom the Software is furnished to do so, 
+// subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included 
+// in all copies or substantial portions of the Software.
+
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, 
+// EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF 
+// MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. 
+// IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY 
+// CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT, 
+// TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE 
+// SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+
+//------------------------------------------------------------------------------
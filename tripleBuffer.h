@@ -0,0 +1,61 @@
+#ifndef _TRIPLE_BUFFER
+#define _TRIPLE_BUFFER
+
+#include <atomic>
+
+#include "cacheLine.h"
+
+/*---------------------------------------------------------------------------*\
+|   Wait-Free Triple Buffer                                                   |
+|                                                                             |
+|   Hands a complete data set from one writer thread to one reader thread.    |
+|   The writer fills writeBuffer() and calls publish(), the reader gets the   |
+|   latest published set with readBuffer(). Neither side ever blocks, and     |
+|   the reader never sees a partially written set.                            |
+\*---------------------------------------------------------------------------*/
+
+template <class T>
+class TripleBuffer
+{
+protected:
+    T buffer[3];
+    alignas(cache_line_size) std::atomic<int> middle;   // index of the middle buffer, bit 2: new data
+    alignas(cache_line_size) int back;                  // owned by the writer
+    alignas(cache_line_size) int front;                 // owned by the reader
+
+public:
+    TripleBuffer(void) : middle(1), back(2), front(0) {}
+
+    // writer side
+    T *writeBuffer(void)
+    {
+        return &buffer[back];
+    }
+
+    void publish(void)
+    {
+        back = middle.exchange(back | 4, std::memory_order_acq_rel) & 3;
+    }
+
+    // reader side
+    const T *readBuffer(void)
+    {
+        if (middle.load(std::memory_order_relaxed) & 4)
+            front = middle.exchange(front, std::memory_order_acq_rel) & 3;
+
+        return &buffer[front];
+    }
+
+    // not thread safe, for initialization only
+    void reset(const T &value)
+    {
+        for (int i = 0; i < 3; i++)
+            buffer[i] = value;
+
+        middle.store(1, std::memory_order_relaxed);
+        back = 2;
+        front = 0;
+    }
+};
+
+#endif  // _TRIPLE_BUFFER